@@ -1,3 +0,0 @@
-#include "HistoryRecord.h"
-
-// Nothing needed here as everything is inline in the header.
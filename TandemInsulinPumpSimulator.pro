@@ -1,43 +1,31 @@
-QT       += core gui widgets charts
+# core/     - Qt-free simulation and control logic (static library)
+# app/      - Qt Widgets/Charts GUI on top of the core
+# headless/ - console runner that drives the core without Qt
+# bench/    - micro-benchmarks for the core
+# perf/     - scenario-level performance regression gate (Unix)
+# telemetry/ - tails a shared-memory telemetry feed (Unix)
+# server/   - multi-pump simulation server on a Unix-domain socket (Linux)
+# loadgen/  - load generator for the server (Linux)
+TEMPLATE = subdirs
 
-CONFIG += c++11
+SUBDIRS += \
+    core \
+    app \
+    headless \
+    bench
 
-SOURCES += \
-    AlertDialog.cpp \
-    BolusDeliveryWidget.cpp \
-    BolusDialog.cpp \
-    HistoryManager.cpp \
-    HistoryRecord.cpp \
-    BolusSafetyManager.cpp \
-    CGMGraphWidget.cpp \
-    CgmSimulator.cpp \
-    HistoryDialog.cpp \
-    MainWindow.cpp \
-    ProfileDialog.cpp \
-    PumpController.cpp \
-    UserProfileManager.cpp \
-    WarningChecker.cpp \
-    main.cpp
+app.depends = core
+headless.depends = core
+bench.depends = core
 
-HEADERS += \
-    AlertDialog.h \
-    BolusDeliveryWidget.h \
-    BolusDialog.h \
-    HistoryManager.h \
-    HistoryRecord.h \
-    BolusSafetyManager.h \
-    CGMGraphWidget.h \
-    CgmSimulator.h \
-    HistoryDialog.h \
-    MainWindow.h \
-    ProfileDialog.h \
-    PumpController.h \
-    UserProfile.h \
-    UserProfileManager.h \
-    WarningChecker.h
+unix {
+    SUBDIRS += perf telemetry
+    perf.depends = core
+    telemetry.depends = core
+}
 
-FORMS += \
-    MainWindow.ui
-
-RESOURCES += \
-    icons.qrc
+linux {
+    SUBDIRS += server loadgen
+    server.depends = core
+    loadgen.depends = core
+}
@@ -2,6 +2,8 @@
 #include <QVBoxLayout>
 #include <QHeaderView>
 #include "HistoryRecord.h"
+#include "StringUtil.h"
+#include "Trace.h"
 
 AlertDialog::AlertDialog(HistoryManager* historyMgr, QWidget *parent)
     : QDialog(parent)
@@ -25,21 +27,23 @@ AlertDialog::AlertDialog(HistoryManager* historyMgr, QWidget *parent)
 
 void AlertDialog::updateAlerts()
 {
+    PUMP_TRACE_SCOPE("ui", "AlertDialog::updateAlerts");
     const auto& records = historyManager->getRecords();
 
-    // Collect only warnings from the general history
-    QVector<HistoryRecord> warnings;
+    // Collect only warnings from the general history (by pointer, the
+    // records outlive the rebuild)
+    QVector<const HistoryRecord*> warnings;
     for (const auto& rec : records) {
         if (rec.getRecordType() == RecordType::Warning) {
-            warnings.append(rec);
+            warnings.append(&rec);
         }
     }
 
     table->setRowCount(warnings.size());
 
     for (int i = 0; i < warnings.size(); ++i) {
-        const auto& rec = warnings[i];
-        table->setItem(i, 0, new QTableWidgetItem(rec.getTimestamp()));
-        table->setItem(i, 1, new QTableWidgetItem(rec.getNotes()));
+        const HistoryRecord& rec = *warnings[i];
+        table->setItem(i, 0, new QTableWidgetItem(QString::fromStdString(formatSimTime(rec.getTime()))));
+        table->setItem(i, 1, new QTableWidgetItem(QString::fromStdString(rec.getNotes())));
     }
 }
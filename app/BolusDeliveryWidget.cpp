@@ -5,7 +5,7 @@
 #include <QLabel>
 #include <QDoubleValidator>
 #include <QButtonGroup>
-#include "UserProfile.h"
+#include "BolusCalculator.h"
 
 BolusDeliveryWidget::BolusDeliveryWidget(UserProfileManager* profileMgr,
                                          PumpController* pumpCtrl,
@@ -15,6 +15,7 @@ BolusDeliveryWidget::BolusDeliveryWidget(UserProfileManager* profileMgr,
     , userProfileManager(profileMgr)
     , pumpController(pumpCtrl)
     , cgmSimulator(cgmSim)
+    , previewRequest(0)
 {
     QVBoxLayout* mainLayout = new QVBoxLayout(this);
 
@@ -99,40 +100,44 @@ BolusDeliveryWidget::BolusDeliveryWidget(UserProfileManager* profileMgr,
 
     setLayout(mainLayout);
 
+    // Any edit makes a shown or running preview stale (CGM refreshes of the
+    // BG field are not edits)
+    for (QLineEdit* input : { bgInput, carbsInput, iobInput }) {
+        connect(input, &QLineEdit::textEdited, this, &BolusDeliveryWidget::cancelPreview);
+    }
+    connect(useManualBgRadio, &QRadioButton::toggled, this, &BolusDeliveryWidget::cancelPreview);
+    connect(extendedCheck, &QCheckBox::toggled, this, &BolusDeliveryWidget::cancelPreview);
+    connect(extendedPercent, QOverload<int>::of(&QSpinBox::valueChanged), this, &BolusDeliveryWidget::cancelPreview);
+    connect(extendedHours, QOverload<int>::of(&QSpinBox::valueChanged), this, &BolusDeliveryWidget::cancelPreview);
+
     // Force an update of the BG input's readOnly state.
     onToggleBgSource();
 }
 
 /**
  * @brief Calculates a suggested bolus based on the user profile's carb ratio,
- * correction factor, and target BG, minus the IOB.
+ * correction factor, and target BG in force at the current simulated time,
+ * minus the IOB not already needed for carbs on board. With CGM BG the
+ * correction is projected along the CGM trend (see BolusCalculator).
  */
-double BolusDeliveryWidget::calculateSuggestedBolus(double bgVal, double carbsVal, double iobVal)
+double BolusDeliveryWidget::calculateSuggestedBolus(double bgVal, double carbsVal, double iobVal, double trend)
 {
-    UserProfile prof = userProfileManager->getActiveProfile();
-
-    // Food bolus = Carbs / CarbRatio
-    double foodBolus = 0.0;
-    if (prof.carbRatio > 0.0) {
-        foodBolus = carbsVal / prof.carbRatio;
-    }
-
-    // Correction bolus if BG is above target
-    double correction = 0.0;
-    if (bgVal > prof.targetGlucose && prof.correctionFactor > 0.0) {
-        double diff = bgVal - prof.targetGlucose;
-        correction = diff / prof.correctionFactor;
-    }
-
-    double totalBeforeIOB = foodBolus + correction;
+    SimTime now = cgmSimulator ? cgmSimulator->getSimTime() : SimTime();
+    double carbsOnBoard = cgmSimulator ? cgmSimulator->getCarbsOnBoard() : 0.0;
+    const TherapySettings& settings = userProfileManager->getActiveSnapshot()->schedule.at(now);
 
-    // Subtract IOB, but not below 0
-    double finalBolus = totalBeforeIOB - iobVal;
-    if (finalBolus < 0) {
-        finalBolus = 0.0;
-    }
+    BolusCalcParams params = BolusCalcParams::fromSettings(settings);
+    return BolusCalculator::suggestBolus(params, bgVal, carbsVal, iobVal, trend, carbsOnBoard);
+}
 
-    return finalBolus;
+/**
+ * @brief The CGM's smoothed BG once it has a trend, else the raw reading.
+ */
+double BolusDeliveryWidget::cgmBg() const
+{
+    if (!cgmSimulator) return 7.0;
+    const GlucoseEstimator& estimator = cgmSimulator->getEstimator();
+    return estimator.hasTrend() ? estimator.smoothedBg() : cgmSimulator->getCurrentBg();
 }
 
 /**
@@ -147,6 +152,7 @@ void BolusDeliveryWidget::onCalculateBolus()
 
     // Decide BG from manual or CGM
     double bgVal = 0.0;
+    double trend = 0.0;
     if (useManualBgRadio->isChecked()) {
         bgVal = bgInput->text().toDouble(&okBG);
         if (!okBG) {
@@ -154,7 +160,10 @@ void BolusDeliveryWidget::onCalculateBolus()
             return;
         }
     } else {
-        bgVal = (cgmSimulator ? cgmSimulator->getCurrentBg() : 7.0);
+        bgVal = cgmBg();
+        if (cgmSimulator && cgmSimulator->getEstimator().hasTrend()) {
+            trend = cgmSimulator->getEstimator().rateOfChange();
+        }
         okBG = true;
     }
 
@@ -164,8 +173,46 @@ void BolusDeliveryWidget::onCalculateBolus()
     }
 
     // Calculate and display the suggestion
-    double suggestion = calculateSuggestedBolus(bgVal, carbsVal, iobVal);
+    double suggestion = calculateSuggestedBolus(bgVal, carbsVal, iobVal, trend);
     suggestedBolus->setText(QString::number(suggestion, 'f', 2));
+    startPreview(suggestion, carbsVal);
+}
+
+/**
+ * @brief startPreview projects the suggestion, +/-20% and an extended
+ * split from the live pump state. The curves come back on a worker
+ * thread and are handed to the GUI thread; a result for anything but
+ * the latest request is dropped.
+ */
+void BolusDeliveryWidget::startPreview(double suggestion, double carbsVal)
+{
+    if (!cgmSimulator) return;
+
+    double frac = extendedCheck->isChecked() ? extendedPercent->value() / 100.0 : 0.4;
+    int hours = extendedCheck->isChecked() ? extendedHours->value() : 3;
+    previewRequest = preview.start(cgmSimulator->getSimulation(),
+                                   BolusPreview::standardCandidates(suggestion, frac, hours),
+                                   carbsVal, BolusPreview::defaultHorizonMinutes,
+        [this](std::uint64_t request, std::vector<BolusPreview::Curve> curves) {
+            QMetaObject::invokeMethod(this, [this, request, curves] {
+                onPreviewFinished(request, curves);
+            }, Qt::QueuedConnection);
+        });
+}
+
+void BolusDeliveryWidget::onPreviewFinished(std::uint64_t request, const std::vector<BolusPreview::Curve>& curves)
+{
+    if (request != previewRequest) return;
+    emit previewReady(curves);
+}
+
+void BolusDeliveryWidget::cancelPreview()
+{
+    preview.cancel();
+    if (previewRequest != 0) {
+        previewRequest = 0;
+        emit previewCleared();
+    }
 }
 
 /**
@@ -206,6 +253,13 @@ void BolusDeliveryWidget::onDeliverBolus()
         return;
     }
 
+    // The dose is taken with its meal; its preview no longer applies
+    double carbsVal = carbsInput->text().toDouble(&ok);
+    if (ok && carbsVal > 0.0 && cgmSimulator) {
+        cgmSimulator->addCarbs(carbsVal);
+    }
+    cancelPreview();
+
     // If successful, notify user
     QMessageBox::information(this, "Bolus Delivered",
         QString("Delivered: %1 U").arg(total));
@@ -214,10 +268,10 @@ void BolusDeliveryWidget::onDeliverBolus()
 /**
  * @brief If using CGM BG, auto-fill the bgInput whenever a new BG arrives.
  */
-void BolusDeliveryWidget::onCgmBgUpdated(double newBg)
+void BolusDeliveryWidget::onCgmBgUpdated(double /*newBg*/)
 {
     if (useCgmBgRadio->isChecked()) {
-        bgInput->setText(QString::number(newBg, 'f', 1));
+        bgInput->setText(QString::number(cgmBg(), 'f', 1));
     }
 }
 
@@ -231,7 +285,6 @@ void BolusDeliveryWidget::onToggleBgSource()
 
     // If CGM is selected and we have a CGM reading, display it
     if (!manual && cgmSimulator) {
-        double cgmVal = cgmSimulator->getCurrentBg();
-        bgInput->setText(QString::number(cgmVal, 'f', 1));
+        bgInput->setText(QString::number(cgmBg(), 'f', 1));
     }
 }
@@ -10,11 +10,16 @@
 #include "PumpController.h"
 #include "UserProfileManager.h"
 #include "CgmSimulator.h"
+#include "BolusPreview.h"
 
 /**
  * @brief BolusDeliveryWidget is the UI for manually delivering a bolus.
  * The user can enter Carbs, BG, and IOB, and choose immediate vs. extended.
  * They can also pick Manual BG or auto-populate from CGM.
+ * Calculating a bolus also starts a what-if preview (BolusPreview) of
+ * the next few hours for the suggested dose and its variations; the
+ * curves are announced with previewReady, and a preview is cancelled as
+ * soon as an input changes.
  */
 class BolusDeliveryWidget : public QWidget {
     Q_OBJECT
@@ -25,6 +30,16 @@ public:
                         CgmSimulator* cgmSim = nullptr,
                         QWidget *parent = nullptr);
 
+public slots:
+    /**
+     * @brief cancelPreview stops a running preview and withdraws any shown.
+     */
+    void cancelPreview();
+
+signals:
+    void previewReady(const std::vector<BolusPreview::Curve>& curves);
+    void previewCleared();
+
 private slots:
     void onCalculateBolus();
     void onDeliverBolus();
@@ -32,7 +47,10 @@ private slots:
     void onToggleBgSource();
 
 private:
-    double calculateSuggestedBolus(double bgVal, double carbsVal, double iobVal);
+    double calculateSuggestedBolus(double bgVal, double carbsVal, double iobVal, double trend = 0.0);
+    double cgmBg() const;
+    void startPreview(double suggestion, double carbsVal);
+    void onPreviewFinished(std::uint64_t request, const std::vector<BolusPreview::Curve>& curves);
 
     UserProfileManager* userProfileManager;
     PumpController*     pumpController;
@@ -56,6 +74,9 @@ private:
     // Action buttons
     QPushButton* calcButton;
     QPushButton* deliverButton;
+
+    BolusPreview  preview;
+    std::uint64_t previewRequest;  // 0 when no preview is pending or shown
 };
 
 #endif // BOLUSDELIVERYWIDGET_H
@@ -17,6 +17,8 @@ public:
                          CgmSimulator* sim,
                          QWidget *parent = nullptr);
 
+    BolusDeliveryWidget* getBolusWidget() const { return bolusWidget; }
+
 private:
     BolusDeliveryWidget* bolusWidget;
 };
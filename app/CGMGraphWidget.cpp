@@ -2,11 +2,34 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
+#include "Trace.h"
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief QChartView whose repaints show up in the trace.
+ */
+class TracedChartView : public QChartView
+{
+public:
+    using QChartView::QChartView;
+
+protected:
+    void paintEvent(QPaintEvent* event) override
+    {
+        PUMP_TRACE_SCOPE("ui", "CGMGraphWidget::paint");
+        QChartView::paintEvent(event);
+    }
+};
+
+} // namespace
 
 CGMGraphWidget::CGMGraphWidget(CgmSimulator* simulator, QWidget *parent)
     : QWidget(parent)
     , cgmSimulator(simulator)
     , timeCounter(0)
+    , rangeBeforePreview(0)
 {
     // Create a chart, line series, and axes to plot BG over time
     chart = new QChart();
@@ -34,9 +57,11 @@ CGMGraphWidget::CGMGraphWidget(CgmSimulator* simulator, QWidget *parent)
     axisX->setTitleBrush(QBrush(Qt::white));
     axisY->setTitleBrush(QBrush(Qt::white));
     series->setColor(QColor("#00ccff"));
+    series->setName("CGM");
+    chart->legend()->setLabelColor(Qt::white);
 
     // Put the chart in a QChartView
-    chartView = new QChartView(chart, this);
+    chartView = new TracedChartView(chart, this);
     chartView->setRenderHint(QPainter::Antialiasing);
 
     // ComboBox to pick 1h, 3h, or 6h range (12s, 36s, 72s real time)
@@ -67,6 +92,7 @@ CGMGraphWidget::CGMGraphWidget(CgmSimulator* simulator, QWidget *parent)
  */
 void CGMGraphWidget::updateGraph(double bgValue)
 {
+    PUMP_TRACE_SCOPE("ui", "CGMGraphWidget::updateGraph");
     timeCounter++;
     series->append(timeCounter, bgValue);
 
@@ -86,3 +112,65 @@ void CGMGraphWidget::onRangeChanged(int index)
     int maxSec = rangeComboBox->currentData().toInt();
     axisX->setRange(0, maxSec);
 }
+
+/**
+ * @brief showPreview replaces any shown preview with one dashed curve per
+ * candidate dose, one point per 5 simulated minutes (one graph second)
+ * from the latest reading on. The x-axis is widened to fit the curves.
+ */
+void CGMGraphWidget::showPreview(const std::vector<BolusPreview::Curve>& curves)
+{
+    PUMP_TRACE_SCOPE("ui", "CGMGraphWidget::showPreview");
+    clearPreview();
+
+    static const char* const colors[] = { "#ffcc00", "#66dd66", "#ff6666", "#cc88ff" };
+    int longest = 0;
+    for (std::size_t i = 0; i < curves.size(); ++i) {
+        const BolusPreview::Curve& curve = curves[i];
+        if (curve.blocked || curve.bg.empty()) continue;
+
+        QLineSeries* s = new QLineSeries();
+        s->setName(QString::fromStdString(curve.label));
+        QPen pen(QColor(colors[i % 4]));
+        pen.setStyle(Qt::DashLine);
+        pen.setWidth(2);
+        s->setPen(pen);
+
+        QVector<QPointF> points;
+        points.reserve(static_cast<int>(curve.bg.size()));
+        for (std::size_t k = 0; k < curve.bg.size(); ++k) {
+            points.append(QPointF(timeCounter + static_cast<double>(k), curve.bg[k]));
+        }
+        s->replace(points);
+
+        chart->addSeries(s);
+        s->attachAxis(axisX);
+        s->attachAxis(axisY);
+        previewSeries.append(s);
+        longest = std::max(longest, static_cast<int>(curve.bg.size()) - 1);
+    }
+
+    if (!previewSeries.isEmpty()) {
+        rangeBeforePreview = axisX->max() - axisX->min();
+        if (timeCounter + longest > axisX->max()) {
+            axisX->setRange(axisX->min(), timeCounter + longest);
+        }
+    }
+}
+
+void CGMGraphWidget::clearPreview()
+{
+    if (previewSeries.isEmpty()) return;
+    for (QLineSeries* s : previewSeries) {
+        chart->removeSeries(s);
+        delete s;
+    }
+    previewSeries.clear();
+
+    // Back to the width the user picked, still following the latest reading
+    double min = axisX->min();
+    axisX->setRange(min, min + rangeBeforePreview);
+    if (timeCounter > axisX->max()) {
+        axisX->setRange(timeCounter - rangeBeforePreview, timeCounter);
+    }
+}
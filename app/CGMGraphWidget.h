@@ -6,6 +6,9 @@
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QValueAxis>
 #include <QComboBox>
+#include <QList>
+#include <vector>
+#include "BolusPreview.h"
 #include "CgmSimulator.h"
 
 QT_CHARTS_USE_NAMESPACE
@@ -13,6 +16,8 @@ QT_CHARTS_USE_NAMESPACE
 /**
  * @brief CGMGraphWidget displays a real-time line graph of BG readings
  * from the simulator, with adjustable time scale (1h, 3h, 6h in simulated terms).
+ * What-if bolus previews can be overlaid as dashed curves starting at the
+ * latest reading.
  */
 class CGMGraphWidget : public QWidget
 {
@@ -21,6 +26,10 @@ class CGMGraphWidget : public QWidget
 public:
     explicit CGMGraphWidget(CgmSimulator* simulator, QWidget *parent = nullptr);
 
+public slots:
+    void showPreview(const std::vector<BolusPreview::Curve>& curves);
+    void clearPreview();
+
 private slots:
     void updateGraph(double bgValue);
     void onRangeChanged(int index);
@@ -35,6 +44,9 @@ private:
     QComboBox*  rangeComboBox;
 
     int timeCounter; // increments by 1 each real second
+
+    QList<QLineSeries*> previewSeries;
+    double rangeBeforePreview;  // x-axis width to go back to when the preview is cleared
 };
 
 #endif // CGMGRAPHWIDGET_H
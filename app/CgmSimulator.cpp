@@ -0,0 +1,78 @@
+#include "CgmSimulator.h"
+#include "StringUtil.h"
+#include "Trace.h"
+
+CgmSimulator::CgmSimulator(PumpSimulation* sim, QObject* parent)
+    : QObject(parent)
+    , simulation(sim)
+    , tickMonitor(sim->getMetrics().registry,
+                  tickIntervalMs * 1000000ull, tickBudgetMs * 1000000ull)
+{
+    // The default coarse timer may fire up to 5% off; the loop's cadence matters here
+    updateTimer.setTimerType(Qt::PreciseTimer);
+    connect(&updateTimer, &QTimer::timeout, this, &CgmSimulator::onTimerTick);
+}
+
+double CgmSimulator::getCurrentBg() const
+{
+    return simulation->getCgmModel().getCurrentBg();
+}
+
+/**
+ * @brief start begins the 1-second timer that represents 5 simulated minutes each tick.
+ */
+void CgmSimulator::start()
+{
+    tickMonitor.resync();
+    updateTimer.start(tickIntervalMs);
+}
+
+/**
+ * @brief getSimTimeStr returns the simulated time as "Day N HH:MM", for display.
+ */
+QString CgmSimulator::getSimTimeStr() const
+{
+    return QString::fromStdString(formatSimTime(getSimTime()));
+}
+
+SimTime CgmSimulator::getSimTime() const
+{
+    return simulation->getCgmModel().getSimTime();
+}
+
+const std::deque<double>& CgmSimulator::getLastSixReadings() const
+{
+    return simulation->getCgmModel().getLastSixReadings();
+}
+
+const GlucoseEstimator& CgmSimulator::getEstimator() const
+{
+    return simulation->getCgmModel().getEstimator();
+}
+
+void CgmSimulator::addCarbs(double grams)
+{
+    simulation->getCarbs().addMeal(grams);
+}
+
+double CgmSimulator::getCarbsOnBoard() const
+{
+    return simulation->getCarbs().getCarbsOnBoard();
+}
+
+/**
+ * @brief onTimerTick is called each real second. The simulation advances
+ * 5 sim minutes and runs the pump logic, then we emit bgUpdated(newBg).
+ */
+void CgmSimulator::onTimerTick()
+{
+    PUMP_TRACE_SCOPE("ui", "CgmSimulator::onTimerTick");
+    tickMonitor.tickStarted(TickMonitor::nowNs());
+    double bg = simulation->step();
+
+    // Notify UI observers (CGMGraphWidget, BolusDeliveryWidget, etc.)
+    PUMP_TRACE_SCOPE("ui", "CgmSimulator::bgUpdated");
+    emit bgUpdated(bg);
+
+    tickMonitor.tickFinished(TickMonitor::nowNs());
+}
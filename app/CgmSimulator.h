@@ -0,0 +1,74 @@
+#ifndef CGMSIMULATOR_H
+#define CGMSIMULATOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <deque>
+#include "PumpSimulation.h"
+#include "TickMonitor.h"
+
+/**
+ * @brief Qt adapter that drives a PumpSimulation from a 1 second timer
+ * (which we treat as 5 minutes of simulated time). The pump logic runs
+ * as a direct call inside the tick; bgUpdated only feeds the UI.
+ * A TickMonitor checks each tick against the period and budget, since
+ * modal dialogs and repaints can hold the timer back.
+ */
+class CgmSimulator : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int tickIntervalMs = 1000;
+    static constexpr int tickBudgetMs = 100;
+
+    explicit CgmSimulator(PumpSimulation* sim, QObject* parent = nullptr);
+
+    double getCurrentBg() const;
+    void start();
+    QString getSimTimeStr() const;
+    SimTime getSimTime() const;
+
+    /**
+     * @brief Return the last 6 readings in chronological order (oldest first).
+     */
+    const std::deque<double>& getLastSixReadings() const;
+
+    /**
+     * @brief Smoothed BG and trend (see GlucoseEstimator).
+     */
+    const GlucoseEstimator& getEstimator() const;
+
+    /**
+     * @brief Cadence of the timer loop: jitter, late and skipped ticks, overruns.
+     */
+    const TickMonitor& getTickMonitor() const { return tickMonitor; }
+
+    /**
+     * @brief The simulation the timer drives, e.g. to fork what-if previews.
+     */
+    const PumpSimulation& getSimulation() const { return *simulation; }
+
+    /**
+     * @brief addCarbs records a meal entered in the UI; its carbs on
+     * board feed Control-IQ and later bolus suggestions, and move BG when
+     * the simulation models physiology.
+     */
+    void addCarbs(double grams);
+    double getCarbsOnBoard() const;
+
+signals:
+    /**
+     * @brief Emitted each time a new BG reading is generated.
+     */
+    void bgUpdated(double newBg);
+
+private slots:
+    void onTimerTick();
+
+private:
+    PumpSimulation* simulation;
+    QTimer updateTimer;
+    TickMonitor tickMonitor;
+};
+
+#endif // CGMSIMULATOR_H
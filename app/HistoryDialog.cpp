@@ -2,6 +2,8 @@
 #include <QVBoxLayout>
 #include <QHeaderView>
 #include "HistoryRecord.h"
+#include "StringUtil.h"
+#include "Trace.h"
 
 HistoryDialog::HistoryDialog(HistoryManager* manager, QWidget* parent)
     : QDialog(parent)
@@ -30,6 +32,7 @@ HistoryDialog::HistoryDialog(HistoryManager* manager, QWidget* parent)
  */
 void HistoryDialog::updateTable()
 {
+    PUMP_TRACE_SCOPE("ui", "HistoryDialog::updateTable");
     const auto& records = historyManager->getRecords();
     table->setRowCount(static_cast<int>(records.size()));
 
@@ -37,18 +40,10 @@ void HistoryDialog::updateTable()
         const HistoryRecord& rec = records[i];
 
         // Time
-        table->setItem(i, 0, new QTableWidgetItem(rec.getTimestamp()));
+        table->setItem(i, 0, new QTableWidgetItem(QString::fromStdString(formatSimTime(rec.getTime()))));
 
         // Type
-        QString typeStr;
-        switch(rec.getRecordType()) {
-        case RecordType::ManualBolus: typeStr = "Manual Bolus"; break;
-        case RecordType::AutoBolus:   typeStr = "Auto Bolus";   break;
-        case RecordType::CgmReading:  typeStr = "CGM Reading";  break;
-        case RecordType::Warning:     typeStr = "Warning";      break;
-        default:                      typeStr = "Other";        break;
-        }
-        table->setItem(i, 1, new QTableWidgetItem(typeStr));
+        table->setItem(i, 1, new QTableWidgetItem(QString::fromLatin1(recordTypeName(rec.getRecordType()))));
 
         // Amount (only relevant for boluses)
         if (rec.getInsulinAmount() > 0) {
@@ -59,6 +54,6 @@ void HistoryDialog::updateTable()
         }
 
         // Notes
-        table->setItem(i, 3, new QTableWidgetItem(rec.getNotes()));
+        table->setItem(i, 3, new QTableWidgetItem(QString::fromStdString(rec.getNotes())));
     }
 }
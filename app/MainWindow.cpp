@@ -0,0 +1,307 @@
+#include "MainWindow.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QDateTime>
+#include <QIcon>
+#include <QFrame>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QStandardPaths>
+
+/**
+ * @brief Constructs the MainWindow, creates all managers/controllers,
+ * initializes the UI, and starts the CGM + warning checks.
+ */
+MainWindow::MainWindow(QWidget *parent)
+    : QMainWindow(parent)
+{
+    // Borrow the backend managers from the simulation core and wrap it
+    // in the Qt adapters the widgets talk to
+    userProfileManager  = &simulation.getProfileManager();
+    bolusSafetyManager  = &simulation.getSafetyManager();
+    historyManager      = &simulation.getHistoryManager();
+    cgmSimulator        = new CgmSimulator(&simulation, this);
+    pumpController      = new PumpController(&simulation.getPumpEngine(), this);
+
+    // Create a WarningChecker for BG warnings and battery/insulin alerts
+    warningChecker = new WarningChecker(&simulation.getWarningMonitor(), &simulation.getDevice(), this);
+    connect(cgmSimulator, &CgmSimulator::bgUpdated, warningChecker, &WarningChecker::showDeviceAlerts);
+
+    // Restore the saved profile library before any dialog reads it
+    profileLibraryPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                         + "/profiles.bin";
+    loadProfileLibrary();
+
+    // The patient's day (meals, exercise, device levels) is a scenario script
+    loadScenario();
+
+    // Build the battery indicator UI
+    batteryBarsWidget = new QWidget(this);
+    QHBoxLayout* batteryBarsLayout = new QHBoxLayout(batteryBarsWidget);
+    batteryBarsLayout->setSpacing(2);
+    for(int i=0; i<5; i++){
+        QFrame* bar = new QFrame(this);
+        bar->setFixedSize(8, 20);
+        bar->setStyleSheet("background-color: #00ff00;"); // green bars
+        batteryBarsLayout->addWidget(bar);
+    }
+    batteryTextLabel = new QLabel("100%", this);
+
+    // Build the insulin reservoir UI
+    insulinBarsWidget = new QWidget(this);
+    QHBoxLayout* insulinBarsLayout = new QHBoxLayout(insulinBarsWidget);
+    insulinBarsLayout->setSpacing(2);
+    for(int i=0; i<5; i++){
+        QFrame* bar = new QFrame(this);
+        bar->setFixedSize(8, 20);
+        bar->setStyleSheet("background-color: #3399ff;"); // blue bars
+        insulinBarsLayout->addWidget(bar);
+    }
+    insulinTextLabel = new QLabel("300U", this);
+
+    // Time display label
+    timeLabel = new QLabel("--:--", this);
+    timeLabel->setAlignment(Qt::AlignCenter);
+    loopLabel = new QLabel(this);
+    loopLabel->setAlignment(Qt::AlignCenter);
+
+    // Create navigation buttons
+    bolusButton   = new QPushButton(QIcon(":/icons/icons/drop.png"), "Bolus", this);
+    profileButton = new QPushButton(QIcon(":/icons/icons/setting.png"), "Profiles", this);
+    historyButton = new QPushButton(QIcon(":/icons/icons/history.png"), "History", this);
+    alertButton   = new QPushButton(QIcon(":/icons/icons/warning.png"), "Alerts", this);
+
+    // CGM Graph area
+    cgmGraphWidget = new CGMGraphWidget(cgmSimulator, this);
+
+    // Connect button signals to the appropriate slots
+    connect(bolusButton,   &QPushButton::clicked, this, &MainWindow::openBolusDialog);
+    connect(profileButton, &QPushButton::clicked, this, &MainWindow::openProfiles);
+    connect(historyButton, &QPushButton::clicked, this, &MainWindow::openHistory);
+    connect(alertButton,   &QPushButton::clicked, this, &MainWindow::openAlerts);
+
+    // Create the dialogs
+    bolusDialog   = new BolusDialog(userProfileManager, pumpController, cgmSimulator, this);
+    profileDialog = new ProfileDialog(userProfileManager, this);
+    histDialog    = new HistoryDialog(historyManager, this);
+    alertDialog   = new AlertDialog(historyManager, this);
+
+    // What-if bolus previews are drawn over the BG graph while the bolus dialog is open
+    connect(bolusDialog->getBolusWidget(), &BolusDeliveryWidget::previewReady,
+            cgmGraphWidget, &CGMGraphWidget::showPreview);
+    connect(bolusDialog->getBolusWidget(), &BolusDeliveryWidget::previewCleared,
+            cgmGraphWidget, &CGMGraphWidget::clearPreview);
+    connect(bolusDialog, &QDialog::finished, bolusDialog->getBolusWidget(), &BolusDeliveryWidget::cancelPreview);
+
+    // Layout the top bar with battery, time, and insulin indicators
+    QWidget* central = new QWidget(this);
+    QVBoxLayout* mainLayout = new QVBoxLayout(central);
+
+    QHBoxLayout* topLayout = new QHBoxLayout();
+    QVBoxLayout* batteryLayout = new QVBoxLayout();
+    batteryLayout->addWidget(batteryBarsWidget);
+    batteryLayout->addWidget(batteryTextLabel);
+
+    QVBoxLayout* insulinLayout = new QVBoxLayout();
+    insulinLayout->addWidget(insulinBarsWidget);
+    insulinLayout->addWidget(insulinTextLabel);
+
+    topLayout->addLayout(batteryLayout);
+    topLayout->addStretch();
+    QVBoxLayout* timeLayout = new QVBoxLayout();
+    timeLayout->addWidget(timeLabel);
+    timeLayout->addWidget(loopLabel);
+    topLayout->addLayout(timeLayout);
+    topLayout->addStretch();
+    topLayout->addLayout(insulinLayout);
+
+    // Next row: navigation buttons
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    buttonLayout->addWidget(bolusButton);
+    buttonLayout->addWidget(profileButton);
+    buttonLayout->addWidget(historyButton);
+    buttonLayout->addWidget(alertButton);
+
+    // Add top and button layouts, plus the CGM graph
+    mainLayout->addLayout(topLayout);
+    mainLayout->addLayout(buttonLayout);
+    mainLayout->addWidget(cgmGraphWidget);
+
+    central->setLayout(mainLayout);
+    setCentralWidget(central);
+
+    // Set the window title
+    setWindowTitle("t:slim X2 Pump Simulation");
+
+    // Start the CGM simulation and the warning checker
+    cgmSimulator->start();
+    warningChecker->startMonitoring();
+
+    // Dark background styling
+    setStyleSheet(R"(
+        QWidget {
+            background-color: #1c1b1b;
+            color: #eeeeee;
+        }
+    )");
+
+    // Timer that updates clock/battery display every second
+    uiRefreshTimer = new QTimer(this);
+    connect(uiRefreshTimer, &QTimer::timeout, this, &MainWindow::updateTime);
+    uiRefreshTimer->start(1000);
+
+    // Prometheus-style text dump of the pump's metrics every 10s, if asked for
+    metricsPath = qEnvironmentVariable("PUMPSIM_METRICS");
+    metricsTimer = new QTimer(this);
+    connect(metricsTimer, &QTimer::timeout, this, &MainWindow::dumpMetrics);
+    if (!metricsPath.isEmpty()) {
+        metricsTimer->start(10000);
+    }
+
+    // Readings, decisions and deliveries for external tools, if asked for
+    QString telemetryName = qEnvironmentVariable("PUMPSIM_TELEMETRY");
+    if (!telemetryName.isEmpty()) {
+        std::string error;
+        if (telemetry.create(telemetryName.toStdString(), TelemetryFeed::defaultCapacity, error)) {
+            simulation.getPumpEngine().setTelemetry(&telemetry);
+        } else {
+            qWarning("%s", error.c_str());
+        }
+    }
+
+    updateTime();
+}
+
+/**
+ * @brief dumpMetrics rewrites the metrics file; failures go to the
+ * console rather than a modal box, since this runs on a timer.
+ */
+void MainWindow::dumpMetrics()
+{
+    std::string error;
+    if (!simulation.getMetrics().registry.writeText(metricsPath.toStdString(), error)) {
+        qWarning("%s", error.c_str());
+    }
+}
+
+/**
+ * @brief MainWindow destructor.
+ * Saves any unsaved profile edits. Qt automatically cleans up child widgets
+ * and dynamically allocated objects with a valid parent.
+ */
+MainWindow::~MainWindow()
+{
+    saveProfileLibrary();
+}
+
+void MainWindow::loadProfileLibrary()
+{
+    if (!QFileInfo::exists(profileLibraryPath)) return;
+
+    std::string error;
+    if (!userProfileManager->loadLibrary(profileLibraryPath.toStdString(), error)) {
+        QMessageBox::warning(this, "Profiles",
+                             QString("Could not load saved profiles:\n%1")
+                             .arg(QString::fromStdString(error)));
+    }
+}
+
+void MainWindow::saveProfileLibrary()
+{
+    if (!userProfileManager->hasUnsavedChanges()) return;
+
+    QDir().mkpath(QFileInfo(profileLibraryPath).absolutePath());
+    std::string error;
+    if (!userProfileManager->saveLibrary(profileLibraryPath.toStdString(), error)) {
+        qWarning("Could not save profiles: %s", error.c_str());
+    }
+}
+
+/**
+ * @brief loadScenario scripts the simulated patient: the file named by
+ * PUMPSIM_SCENARIO if set, else the built-in demo day.
+ */
+void MainWindow::loadScenario()
+{
+    QString path = qEnvironmentVariable("PUMPSIM_SCENARIO", ":/scenarios/demo.scn");
+    QFile file(path);
+    auto scenario = std::make_shared<Scenario>();
+    std::string error = "Cannot open " + path.toStdString();
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)
+        || !Scenario::parse(file.readAll().toStdString(), *scenario, error)) {
+        QMessageBox::warning(this, "Scenario",
+                             QString("Could not load scenario %1:\n%2")
+                             .arg(path, QString::fromStdString(error)));
+        return;
+    }
+    simulation.setScenario(scenario);
+}
+
+/**
+ * @brief Opens the Manual Bolus dialog (BolusDialog).
+ */
+void MainWindow::openBolusDialog()
+{
+    bolusDialog->exec();
+}
+
+/**
+ * @brief Opens the Profile management dialog and saves any edits made in it.
+ */
+void MainWindow::openProfiles()
+{
+    profileDialog->exec();
+    saveProfileLibrary();
+}
+
+/**
+ * @brief Opens the History dialog, which shows logs of all events.
+ */
+void MainWindow::openHistory()
+{
+    histDialog->updateTable();
+    histDialog->exec();
+}
+
+/**
+ * @brief Opens the Alerts dialog, showing any warnings (battery low, insulin low, etc.).
+ */
+void MainWindow::openAlerts()
+{
+    alertDialog->updateAlerts();
+    alertDialog->exec();
+}
+
+/**
+ * @brief Called every second by uiRefreshTimer.
+ * Updates the displayed time, battery %, and insulin reservoir if needed.
+ */
+void MainWindow::updateTime()
+{
+    // Show actual local date/time (though the pump sim has a "simulated time" for BG events).
+    QDateTime now = QDateTime::currentDateTime();
+    timeLabel->setText(now.toString("hh:mm AP\nddd, dd MMM"));
+
+    // Display battery level and insulin reservoir from the pump device
+    int battery = simulation.getDevice().getBatteryPercent();
+    batteryTextLabel->setText(QString("%1%").arg(battery));
+
+    double ins = simulation.getDevice().getReservoir();
+    insulinTextLabel->setText(QString("%1U").arg(ins,0,'f',0));
+
+    // CGM loop cadence: red once any tick has been late or skipped
+    TickMonitor::Summary loop = cgmSimulator->getTickMonitor().summary();
+    if (loop.deadlineMisses == 0) {
+        loopLabel->setText(QString("Loop on time (jitter p99 %1 ms)")
+                           .arg(loop.jitterP99Ns / 1e6, 0, 'f', 1));
+        loopLabel->setStyleSheet("color: #8fd18f; font-size: 10px;");
+    } else {
+        loopLabel->setText(QString("Loop: %1 late, %2 skipped (max %3 ms)")
+                           .arg(loop.deadlineMisses)
+                           .arg(loop.missedPeriods)
+                           .arg(loop.jitterMaxNs / 1e6, 0, 'f', 0));
+        loopLabel->setStyleSheet("color: #ff6666; font-size: 10px;");
+    }
+}
@@ -5,6 +5,8 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QTimer>
+#include "PumpSimulation.h"
+#include "TelemetryFeed.h"
 #include "UserProfileManager.h"
 #include "BolusSafetyManager.h"
 #include "HistoryManager.h"
@@ -20,8 +22,9 @@
 /**
  * @brief MainWindow is the top-level container for our insulin pump simulation UI.
  * It sets up the battery/insulin indicators, time display, navigation buttons,
- * and the CGM graph area. It also manages the major backend objects
- * (UserProfileManager, PumpController, etc.) and starts the CGM/Warning logic.
+ * and the CGM graph area. It owns the PumpSimulation core, wraps it in the
+ * Qt adapters (CgmSimulator, PumpController, WarningChecker) and starts the
+ * CGM/Warning logic.
  */
 class MainWindow : public QMainWindow
 {
@@ -36,9 +39,24 @@ private slots:
     void openHistory();
     void openAlerts();
     void updateTime();
+    void dumpMetrics();
 
 private:
-    // Core logic objects
+    /**
+     * @brief Loads the profile library from profileLibraryPath, if present,
+     * and writes it back when it has unsaved changes.
+     */
+    void loadProfileLibrary();
+    void saveProfileLibrary();
+    void loadScenario();
+
+    // Shared-memory feed of the pump's events (PUMPSIM_TELEMETRY=<name>); closed = off
+    TelemetryFeed telemetry;
+
+    // The Qt-free pump core; the pointers below refer into it
+    PumpSimulation simulation;
+
+    // Core logic objects and their Qt adapters
     UserProfileManager* userProfileManager;
     BolusSafetyManager* bolusSafetyManager;
     HistoryManager*     historyManager;
@@ -52,6 +70,7 @@ private:
     QLabel* insulinTextLabel;
     QWidget* insulinBarsWidget;
     QLabel* timeLabel;
+    QLabel* loopLabel;  // CGM loop cadence (see TickMonitor)
 
     // Navigation buttons
     QPushButton* bolusButton;
@@ -70,6 +89,13 @@ private:
 
     // Timer to periodically update UI time/battery display
     QTimer* uiRefreshTimer;
+
+    // Where the profile library is persisted between runs
+    QString profileLibraryPath;
+
+    // Periodic metrics dump (PUMPSIM_METRICS=<file>); empty path = off
+    QTimer* metricsTimer;
+    QString metricsPath;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,254 @@
+#include "ProfileDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QInputDialog>
+#include <QMessageBox>
+#include "SegmentDialog.h"
+#include "UserProfile.h"
+
+ProfileDialog::ProfileDialog(UserProfileManager* mgr, QWidget *parent)
+    : QDialog(parent)
+    , profileManager(mgr)
+    , currentPage(0)
+{
+    setWindowTitle("Profile Manager");
+    resize(400, 300);
+
+    profileList  = new QListWidget(this);
+    addButton    = new QPushButton("Add", this);
+    editButton   = new QPushButton("Edit", this);
+    deleteButton = new QPushButton("Delete", this);
+    segmentsButton = new QPushButton("Segments", this);
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout;
+    buttonLayout->addWidget(addButton);
+    buttonLayout->addWidget(editButton);
+    buttonLayout->addWidget(deleteButton);
+    buttonLayout->addWidget(segmentsButton);
+
+    // Search by name and page through the library
+    searchInput = new QLineEdit(this);
+    searchInput->setPlaceholderText("Profile name");
+    findButton  = new QPushButton("Find", this);
+    prevButton  = new QPushButton("<", this);
+    nextButton  = new QPushButton(">", this);
+    pageLabel   = new QLabel(this);
+    pageLabel->setAlignment(Qt::AlignCenter);
+
+    QHBoxLayout* searchLayout = new QHBoxLayout;
+    searchLayout->addWidget(searchInput);
+    searchLayout->addWidget(findButton);
+
+    QHBoxLayout* pageLayout = new QHBoxLayout;
+    pageLayout->addWidget(prevButton);
+    pageLayout->addWidget(pageLabel);
+    pageLayout->addWidget(nextButton);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    mainLayout->addLayout(searchLayout);
+    mainLayout->addWidget(profileList);
+    mainLayout->addLayout(pageLayout);
+    mainLayout->addLayout(buttonLayout);
+    setLayout(mainLayout);
+
+    // Hook up button signals
+    connect(addButton,    &QPushButton::clicked, this, &ProfileDialog::onAddProfile);
+    connect(editButton,   &QPushButton::clicked, this, &ProfileDialog::onEditProfile);
+    connect(deleteButton, &QPushButton::clicked, this, &ProfileDialog::onDeleteProfile);
+    connect(segmentsButton, &QPushButton::clicked, this, &ProfileDialog::onEditSegments);
+    connect(profileList,  &QListWidget::itemDoubleClicked, this, &ProfileDialog::onProfileActivated);
+    connect(prevButton,   &QPushButton::clicked, this, &ProfileDialog::onPrevPage);
+    connect(nextButton,   &QPushButton::clicked, this, &ProfileDialog::onNextPage);
+    connect(findButton,   &QPushButton::clicked, this, &ProfileDialog::onFindProfile);
+    connect(searchInput,  &QLineEdit::returnPressed, this, &ProfileDialog::onFindProfile);
+
+    // Load initial list from the manager
+    refreshProfileList();
+}
+
+/**
+ * @brief refreshProfileList reloads the ListWidget with the current page of
+ * profile names. Only names are read; full profiles stay on disk until used.
+ */
+void ProfileDialog::refreshProfileList()
+{
+    int count = profileManager->getProfileCount();
+    int pages = qMax(1, (count + pageSize - 1) / pageSize);
+    currentPage = qBound(0, currentPage, pages - 1);
+
+    profileList->clear();
+    int first = currentPage * pageSize;
+    int last  = qMin(count, first + pageSize);
+    for (int i = first; i < last; ++i) {
+        profileList->addItem(QString::fromStdString(profileManager->getProfileName(i)));
+    }
+
+    pageLabel->setText(QString("Page %1 of %2 (%3 profiles)")
+                       .arg(currentPage + 1).arg(pages).arg(count));
+    prevButton->setEnabled(currentPage > 0);
+    nextButton->setEnabled(currentPage < pages - 1);
+}
+
+/**
+ * @brief selectedIndex maps the selected row on this page to a library index.
+ * @return -1 if nothing is selected
+ */
+int ProfileDialog::selectedIndex() const
+{
+    int row = profileList->currentRow();
+    if (row < 0) return -1;
+    int index = currentPage * pageSize + row;
+    return index < profileManager->getProfileCount() ? index : -1;
+}
+
+void ProfileDialog::onPrevPage()
+{
+    --currentPage;
+    refreshProfileList();
+}
+
+void ProfileDialog::onNextPage()
+{
+    ++currentPage;
+    refreshProfileList();
+}
+
+/**
+ * @brief onFindProfile looks the name up in the library's hash index and
+ * jumps to its page.
+ */
+void ProfileDialog::onFindProfile()
+{
+    QString name = searchInput->text().trimmed();
+    if (name.isEmpty()) return;
+
+    int index = profileManager->findProfile(name.toStdString());
+    if (index < 0) {
+        QMessageBox::information(this, "Find Profile",
+                                 QString("No profile named '%1'.").arg(name));
+        return;
+    }
+    currentPage = index / pageSize;
+    refreshProfileList();
+    profileList->setCurrentRow(index % pageSize);
+}
+
+/**
+ * @brief getProfileInput uses QInputDialog to collect profile data from the user.
+ */
+bool ProfileDialog::getProfileInput(UserProfile &profile, const QString &title)
+{
+    bool ok = false;
+    QString name = QInputDialog::getText(this, title, "Profile Name:",
+                                         QLineEdit::Normal,
+                                         QString::fromStdString(profile.name), &ok);
+    if (!ok || name.isEmpty()) return false;
+
+    double basal = QInputDialog::getDouble(this, title, "Basal Rate (U/hr):",
+                                           profile.basalRate, 0, 100, 1, &ok);
+    if (!ok) return false;
+
+    double carbRatio = QInputDialog::getDouble(this, title, "Carb Ratio (g/U):",
+                                               profile.carbRatio, 0, 1000, 1, &ok);
+    if (!ok) return false;
+
+    double cf = QInputDialog::getDouble(this, title, "Correction Factor (mmol/L per U):",
+                                        profile.correctionFactor, 0, 50, 1, &ok);
+    if (!ok) return false;
+
+    double tgt = QInputDialog::getDouble(this, title, "Target BG (mmol/L):",
+                                         profile.targetGlucose, 3, 30, 1, &ok);
+    if (!ok) return false;
+
+    double maxBolus = QInputDialog::getDouble(this, title, "Max Bolus (U):",
+                                              profile.safetyLimits.maxSingleBolus, 0.5, 25, 1, &ok);
+    if (!ok) return false;
+
+    // Assign results
+    profile.name = name.toStdString();
+    profile.basalRate = basal;
+    profile.carbRatio = carbRatio;
+    profile.correctionFactor = cf;
+    profile.targetGlucose = tgt;
+    profile.safetyLimits.maxSingleBolus = maxBolus;
+
+    return true;
+}
+
+/**
+ * @brief Adds a new profile by collecting user input.
+ */
+void ProfileDialog::onAddProfile()
+{
+    UserProfile newProfile;
+    // Provide some default example values
+    newProfile.basalRate       = 1.0;
+    newProfile.carbRatio       = 10.0;
+    newProfile.correctionFactor= 2.0;
+    newProfile.targetGlucose   = 6.0;
+
+    if (getProfileInput(newProfile, "Add Profile")) {
+        profileManager->addProfile(newProfile);
+        currentPage = (profileManager->getProfileCount() - 1) / pageSize;
+        refreshProfileList();
+    }
+}
+
+/**
+ * @brief Edits an existing profile from the list.
+ */
+void ProfileDialog::onEditProfile()
+{
+    int index = selectedIndex();
+    if (index < 0) return;
+
+    UserProfile editable = profileManager->getProfile(index);
+    if (getProfileInput(editable, "Edit Profile")) {
+        profileManager->updateProfile(index, editable);
+        refreshProfileList();
+    }
+}
+
+/**
+ * @brief Deletes an existing profile from the list.
+ */
+void ProfileDialog::onDeleteProfile()
+{
+    int index = selectedIndex();
+    if (index < 0) return;
+
+    profileManager->deleteProfile(index);
+    refreshProfileList();
+}
+
+/**
+ * @brief Edits the time-of-day segments of the selected profile.
+ */
+void ProfileDialog::onEditSegments()
+{
+    int index = selectedIndex();
+    if (index < 0) return;
+
+    UserProfile editable = profileManager->getProfile(index);
+    SegmentDialog dlg(editable, this);
+    if (dlg.exec() == QDialog::Accepted) {
+        editable.segments = dlg.getSegments();
+        profileManager->updateProfile(index, editable);
+    }
+}
+
+/**
+ * @brief onProfileActivated is triggered when the user double-clicks a profile.
+ * It sets that profile as active in the manager.
+ */
+void ProfileDialog::onProfileActivated(QListWidgetItem* item)
+{
+    if (!item) return;
+    int index = currentPage * pageSize + profileList->row(item);
+    if (index < 0 || index >= profileManager->getProfileCount()) return;
+
+    profileManager->activateProfile(index);
+    QMessageBox::information(this, "Profile Activated",
+                             QString("Profile '%1' now active.")
+                             .arg(QString::fromStdString(profileManager->getProfileName(index))));
+}
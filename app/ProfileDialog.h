@@ -4,12 +4,16 @@
 #include <QDialog>
 #include <QListWidget>
 #include <QPushButton>
+#include <QLineEdit>
+#include <QLabel>
 #include <QListWidgetItem>
 #include "UserProfileManager.h"
 
 /**
  * @brief ProfileDialog allows the user to create, edit, or delete
  * personal profiles, which store basal rates, carb ratio, correction factor, etc.
+ * The library can hold many thousands of profiles, so the list shows one
+ * page at a time and a name search jumps straight to a profile.
  */
 class ProfileDialog : public QDialog
 {
@@ -21,10 +25,17 @@ private slots:
     void onAddProfile();
     void onEditProfile();
     void onDeleteProfile();
+    void onEditSegments();
     void onProfileActivated(QListWidgetItem* item);
+    void onPrevPage();
+    void onNextPage();
+    void onFindProfile();
 
 private:
+    static constexpr int pageSize = 100;
+
     void refreshProfileList();
+    int selectedIndex() const;
     bool getProfileInput(UserProfile &profile, const QString &title);
 
     UserProfileManager* profileManager;
@@ -32,6 +43,15 @@ private:
     QPushButton* addButton;
     QPushButton* editButton;
     QPushButton* deleteButton;
+    QPushButton* segmentsButton;
+
+    // Paging and search
+    QPushButton* prevButton;
+    QPushButton* nextButton;
+    QLabel*      pageLabel;
+    QLineEdit*   searchInput;
+    QPushButton* findButton;
+    int currentPage;
 };
 
 #endif // PROFILEDIALOG_H
@@ -0,0 +1,19 @@
+#include "PumpController.h"
+
+PumpController::PumpController(PumpEngine* engine, QObject* parent)
+    : QObject(parent),
+      pumpEngine(engine)
+{
+}
+
+/**
+ * @brief requestBolus handles a manual bolus request (carbs/correction).
+ */
+bool PumpController::requestBolus(double totalBolus,
+                                  const QString& notes,
+                                  double extendedFrac,
+                                  int durationHrs)
+{
+    return pumpEngine->requestBolus(totalBolus, notes.toStdString(),
+                                    extendedFrac, durationHrs);
+}
@@ -0,0 +1,33 @@
+#ifndef PUMPCONTROLLER_H
+#define PUMPCONTROLLER_H
+
+#include <QObject>
+#include <QString>
+#include "PumpEngine.h"
+
+/**
+ * @brief PumpController is the Qt-facing side of PumpEngine. It accepts
+ * manual bolus requests from the UI and forwards them to the core;
+ * CGM updates and Control-IQ run inside PumpSimulation::step().
+ */
+class PumpController : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PumpController(PumpEngine* engine, QObject* parent = nullptr);
+
+    /**
+     * @brief requestBolus attempts to deliver a manual bolus
+     * (possibly extended), checking safety constraints
+     * and logging events in the history.
+     */
+    bool requestBolus(double totalBolus,
+                      const QString& notes,
+                      double extendedFrac = 0.0,
+                      int durationHrs = 0);
+
+private:
+    PumpEngine* pumpEngine;
+};
+
+#endif // PUMPCONTROLLER_H
@@ -0,0 +1,119 @@
+#include "SegmentDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QDialogButtonBox>
+#include <QMessageBox>
+#include <QTime>
+
+SegmentDialog::SegmentDialog(const UserProfile& profile, QWidget* parent)
+    : QDialog(parent)
+    , defaults(profile.baseSettings())
+    , segments(profile.segments)
+{
+    setWindowTitle(QString("Time Segments - %1").arg(QString::fromStdString(profile.name)));
+    resize(560, 320);
+
+    // One row per segment: start time plus the four settings
+    table = new QTableWidget(this);
+    table->setColumnCount(5);
+    table->setHorizontalHeaderLabels({"Start (HH:MM)", "Basal (U/hr)", "Carb Ratio (g/U)",
+                                      "Correction (mmol/L/U)", "Target (mmol/L)"});
+    table->horizontalHeader()->setStretchLastSection(true);
+
+    addButton    = new QPushButton("Add Segment", this);
+    removeButton = new QPushButton("Remove Segment", this);
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout;
+    buttonLayout->addWidget(addButton);
+    buttonLayout->addWidget(removeButton);
+
+    QDialogButtonBox* okCancel = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    mainLayout->addWidget(table);
+    mainLayout->addLayout(buttonLayout);
+    mainLayout->addWidget(okCancel);
+    setLayout(mainLayout);
+
+    connect(addButton,    &QPushButton::clicked, this, &SegmentDialog::onAddSegment);
+    connect(removeButton, &QPushButton::clicked, this, &SegmentDialog::onRemoveSegment);
+    connect(okCancel, &QDialogButtonBox::accepted, this, &SegmentDialog::onAccept);
+    connect(okCancel, &QDialogButtonBox::rejected, this, &SegmentDialog::reject);
+
+    for (const TherapySegment& seg : segments) {
+        addRow(seg);
+    }
+}
+
+/**
+ * @brief addRow appends a segment to the table as editable text cells.
+ */
+void SegmentDialog::addRow(const TherapySegment& segment)
+{
+    int row = table->rowCount();
+    table->insertRow(row);
+
+    QTime start = QTime(0, 0).addSecs(segment.startMinute * 60);
+    table->setItem(row, 0, new QTableWidgetItem(start.toString("HH:mm")));
+    table->setItem(row, 1, new QTableWidgetItem(QString::number(segment.settings.basalRate, 'f', 2)));
+    table->setItem(row, 2, new QTableWidgetItem(QString::number(segment.settings.carbRatio, 'f', 1)));
+    table->setItem(row, 3, new QTableWidgetItem(QString::number(segment.settings.correctionFactor, 'f', 1)));
+    table->setItem(row, 4, new QTableWidgetItem(QString::number(segment.settings.targetGlucose, 'f', 1)));
+}
+
+/**
+ * @brief Adds a segment at 12:00 with the profile's base settings.
+ */
+void SegmentDialog::onAddSegment()
+{
+    if (table->rowCount() >= UserProfile::maxSegments) {
+        QMessageBox::warning(this, "Segments",
+                             QString("A profile can have at most %1 segments.")
+                             .arg(UserProfile::maxSegments));
+        return;
+    }
+    addRow({ 12 * 60, defaults });
+}
+
+void SegmentDialog::onRemoveSegment()
+{
+    int row = table->currentRow();
+    if (row >= 0) {
+        table->removeRow(row);
+    }
+}
+
+/**
+ * @brief onAccept parses every row; any invalid cell keeps the dialog open.
+ */
+void SegmentDialog::onAccept()
+{
+    std::vector<TherapySegment> parsed;
+    for (int row = 0; row < table->rowCount(); ++row) {
+        auto cellText = [this, row](int col) {
+            QTableWidgetItem* item = table->item(row, col);
+            return item ? item->text().trimmed() : QString();
+        };
+
+        QTime start = QTime::fromString(cellText(0), "HH:mm");
+        bool okBasal, okCarb, okCf, okTarget;
+        TherapySettings s;
+        s.basalRate        = cellText(1).toDouble(&okBasal);
+        s.carbRatio        = cellText(2).toDouble(&okCarb);
+        s.correctionFactor = cellText(3).toDouble(&okCf);
+        s.targetGlucose    = cellText(4).toDouble(&okTarget);
+
+        if (!start.isValid() || !okBasal || !okCarb || !okCf || !okTarget
+            || s.basalRate < 0 || s.carbRatio < 0 || s.correctionFactor < 0
+            || s.targetGlucose < 3 || s.targetGlucose > 30) {
+            QMessageBox::warning(this, "Invalid Segment",
+                                 QString("Please check the values in row %1.").arg(row + 1));
+            return;
+        }
+        parsed.push_back({ start.hour() * 60 + start.minute(), s });
+    }
+
+    segments = parsed;
+    accept();
+}
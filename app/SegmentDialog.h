@@ -0,0 +1,41 @@
+#ifndef SEGMENTDIALOG_H
+#define SEGMENTDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QPushButton>
+#include <vector>
+#include "UserProfile.h"
+
+/**
+ * @brief SegmentDialog edits a profile's time-of-day segments: for each
+ * start time, the basal rate, carb ratio, correction factor and target BG
+ * that apply until the next segment.
+ */
+class SegmentDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit SegmentDialog(const UserProfile& profile, QWidget* parent = nullptr);
+
+    /**
+     * @brief The edited segments, valid after the dialog was accepted.
+     */
+    std::vector<TherapySegment> getSegments() const { return segments; }
+
+private slots:
+    void onAddSegment();
+    void onRemoveSegment();
+    void onAccept();
+
+private:
+    void addRow(const TherapySegment& segment);
+
+    QTableWidget* table;
+    QPushButton* addButton;
+    QPushButton* removeButton;
+    TherapySettings defaults;
+    std::vector<TherapySegment> segments;
+};
+
+#endif // SEGMENTDIALOG_H
@@ -0,0 +1,73 @@
+#include "WarningChecker.h"
+#include <QMessageBox>
+#include "Trace.h"
+
+WarningChecker::WarningChecker(WarningMonitor* monitor, PumpDevice* device, QObject* parent)
+    : QObject(parent),
+      warningMonitor(monitor),
+      pumpDevice(device)
+{
+    // The timer calls onCheck() every 30s.
+    connect(&checkTimer, &QTimer::timeout, this, &WarningChecker::onCheck);
+}
+
+void WarningChecker::startMonitoring()
+{
+    // Check every 30 seconds (real time)
+    checkTimer.start(30000);
+}
+
+void WarningChecker::stopMonitoring()
+{
+    checkTimer.stop();
+}
+
+/**
+ * @brief onCheck is called every 30s. The monitor logs each warning;
+ * we pop up a dark-themed QMessageBox for it.
+ */
+void WarningChecker::onCheck()
+{
+    PUMP_TRACE_SCOPE("ui", "WarningChecker::onCheck");
+    for (const std::string& msg : warningMonitor->check()) {
+        showDarkWarning("Pump Warning", QString::fromStdString(msg));
+    }
+}
+
+void WarningChecker::showDeviceAlerts()
+{
+    if (!pumpDevice->hasAlerts()) return;
+    for (const DeviceAlert& alert : pumpDevice->takeAlerts()) {
+        showDarkWarning("Pump Warning", QString::fromStdString(alert.message));
+    }
+}
+
+/**
+ * @brief showDarkWarning uses a custom stylesheet to display a dark-themed warning box.
+ */
+void WarningChecker::showDarkWarning(const QString& title, const QString& text)
+{
+    // Modal: the span covers the time the box blocks the event loop
+    PUMP_TRACE_SCOPE("ui", "WarningChecker::showDarkWarning");
+    QMessageBox box(QMessageBox::Warning, title, text, QMessageBox::Ok);
+    box.setStyleSheet(R"(
+        QMessageBox {
+            background-color: #2a2a2a;
+        }
+        QLabel {
+            color: white;
+            font-weight: bold;
+        }
+        QPushButton {
+            background-color: #444;
+            color: white;
+            border: 1px solid #666;
+            padding: 6px;
+            border-radius: 4px;
+        }
+        QPushButton:hover {
+            background-color: #555;
+        }
+    )");
+    box.exec();
+}
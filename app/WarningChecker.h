@@ -0,0 +1,48 @@
+#ifndef WARNINGCHECKER_H
+#define WARNINGCHECKER_H
+
+#include <QObject>
+#include <QTimer>
+#include "PumpDevice.h"
+#include "WarningMonitor.h"
+
+/**
+ * @brief WarningChecker periodically runs the core WarningMonitor (BG)
+ * and shows a message box for every warning it raises. Battery and
+ * reservoir alerts are raised by the PumpDevice when a level crosses a
+ * threshold; showDeviceAlerts() shows any that are waiting.
+ */
+class WarningChecker : public QObject
+{
+    Q_OBJECT
+public:
+    WarningChecker(WarningMonitor* monitor, PumpDevice* device, QObject* parent=nullptr);
+
+    /**
+     * @brief Optionally displays a styled warning message box.
+     */
+    void showDarkWarning(const QString& title, const QString& text);
+
+public slots:
+    /**
+     * @brief Start/stop the internal timer that checks every 30s.
+     */
+    void startMonitoring();
+    void stopMonitoring();
+
+    /**
+     * @brief Shows the device alerts raised since the last call; nothing
+     * to do (one check) when there are none. Connect it to each tick.
+     */
+    void showDeviceAlerts();
+
+private slots:
+    void onCheck();
+
+private:
+    WarningMonitor* warningMonitor;
+    PumpDevice*     pumpDevice;
+    QTimer checkTimer;
+};
+
+#endif // WARNINGCHECKER_H
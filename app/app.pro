@@ -0,0 +1,41 @@
+QT       += core gui widgets charts
+
+CONFIG += c++17
+
+TARGET = TandemInsulinPumpSimulator
+
+include(../core/pumpcore.pri)
+
+SOURCES += \
+    AlertDialog.cpp \
+    BolusDeliveryWidget.cpp \
+    BolusDialog.cpp \
+    CGMGraphWidget.cpp \
+    CgmSimulator.cpp \
+    HistoryDialog.cpp \
+    MainWindow.cpp \
+    ProfileDialog.cpp \
+    PumpController.cpp \
+    SegmentDialog.cpp \
+    WarningChecker.cpp \
+    main.cpp
+
+HEADERS += \
+    AlertDialog.h \
+    BolusDeliveryWidget.h \
+    BolusDialog.h \
+    CGMGraphWidget.h \
+    CgmSimulator.h \
+    HistoryDialog.h \
+    MainWindow.h \
+    ProfileDialog.h \
+    PumpController.h \
+    SegmentDialog.h \
+    WarningChecker.h
+
+FORMS += \
+    MainWindow.ui
+
+RESOURCES += \
+    icons.qrc \
+    scenarios.qrc
@@ -0,0 +1,32 @@
+#include "MainWindow.h"
+#include <QApplication>
+#include <cstdio>
+#include <cstdlib>
+#include "Trace.h"
+
+/**
+ * @brief The entry point of the Qt application.
+ * Creates a QApplication object and shows the MainWindow.
+ * In a trace build, setting PUMPSIM_TRACE=<file> records the session
+ * and writes it there as Chrome trace JSON on exit.
+ */
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+
+    const char* tracePath = std::getenv("PUMPSIM_TRACE");
+    Trace::setEnabled(tracePath && *tracePath);
+
+    // Create and show our main window, which holds the pump UI.
+    MainWindow w;
+    w.show();
+
+    // Start Qt's event loop.
+    int status = a.exec();
+
+    std::string error;
+    if (Trace::isEnabled() && !Trace::writeChromeJson(tracePath, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+    }
+    return status;
+}
@@ -0,0 +1,105 @@
+#include "Bench.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::uint64_t> allocCount { 0 };
+std::atomic<std::uint64_t> allocBytes { 0 };
+
+void* countedAlloc(std::size_t size)
+{
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+/**
+ * @brief Writes s as a JSON string literal (names are ASCII, but quote
+ * and backslash are escaped anyway).
+ */
+void writeJsonString(std::FILE* f, const std::string& s)
+{
+    std::fputc('"', f);
+    for (char c : s) {
+        if (c == '"' || c == '\\') std::fputc('\\', f);
+        std::fputc(c, f);
+    }
+    std::fputc('"', f);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+std::uint64_t BenchAlloc::count() { return allocCount.load(std::memory_order_relaxed); }
+std::uint64_t BenchAlloc::bytes() { return allocBytes.load(std::memory_order_relaxed); }
+
+BenchSuite::BenchSuite(const std::string& filter, double minSeconds)
+    : filter(filter)
+    , minSeconds(minSeconds)
+{
+}
+
+bool BenchSuite::selected(const std::string& name) const
+{
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+void BenchSuite::add(const BenchResult& r)
+{
+    results.push_back(r);
+
+    double nsPerItem = r.nsPerOp / r.itemsPerOp;
+    std::printf("%-44s %12.1f ns/op %10.2f ns/item %9.1f allocs/op %11.0f B/op\n",
+                r.name.c_str(), r.nsPerOp, nsPerItem, r.allocsPerOp, r.bytesPerOp);
+    std::fflush(stdout);
+}
+
+/**
+ * @brief writeJson writes all results as
+ * {"suite": ..., "build": ..., "results": [{name, iterations, ...}]}.
+ */
+bool BenchSuite::writeJson(const std::string& path, std::string& error) const
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        error = "Cannot open " + path + " for writing.";
+        return false;
+    }
+
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+
+    std::fprintf(f, "{\n  \"suite\": \"pumpcore-bench\",\n  \"build\": \"%s\",\n  \"results\": [", build);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        std::fprintf(f, "%s\n    {\"name\": ", i ? "," : "");
+        writeJsonString(f, r.name);
+        std::fprintf(f, ", \"iterations\": %llu, \"items_per_op\": %.17g, \"ns_per_op\": %.6g, "
+                        "\"ns_per_item\": %.6g, \"allocs_per_op\": %.6g, \"bytes_per_op\": %.6g}",
+                     static_cast<unsigned long long>(r.iterations), r.itemsPerOp, r.nsPerOp,
+                     r.nsPerOp / r.itemsPerOp, r.allocsPerOp, r.bytesPerOp);
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+
+    bool ok = std::ferror(f) == 0;
+    if (std::fclose(f) != 0) ok = false;
+    if (!ok) {
+        error = "Failed writing " + path + ".";
+    }
+    return ok;
+}
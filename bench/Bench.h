@@ -0,0 +1,112 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Allocation counters fed by the global operator new replacement
+ * in Bench.cpp. Only the bench executable links it, so the library
+ * itself is untouched.
+ */
+namespace BenchAlloc {
+
+std::uint64_t count();
+std::uint64_t bytes();
+
+} // namespace BenchAlloc
+
+/**
+ * @brief Keeps a value alive so the compiler cannot drop the work that
+ * produced it.
+ */
+template <class T>
+inline void benchKeep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief One benchmark's numbers. An op may cover several items (e.g.
+ * a batch of 10000 decisions); ns and allocations are reported per op.
+ */
+struct BenchResult {
+    std::string name;
+    std::uint64_t iterations = 0;
+    double itemsPerOp = 1.0;
+    double nsPerOp = 0.0;
+    double allocsPerOp = 0.0;
+    double bytesPerOp = 0.0;
+};
+
+/**
+ * @brief BenchSuite runs named ops, picking an iteration count so each
+ * measurement takes at least minSeconds, and collects the results for a
+ * console table and a JSON file.
+ */
+class BenchSuite
+{
+public:
+    BenchSuite(const std::string& filter, double minSeconds);
+
+    bool selected(const std::string& name) const;
+
+    /**
+     * @brief Times op() repeatedly. The iteration count grows until one
+     * batch takes minSeconds; that batch is the one reported.
+     */
+    template <class Op>
+    void run(const std::string& name, double itemsPerOp, Op&& op)
+    {
+        if (!selected(name)) return;
+
+        op();  // warm caches and lazily built state
+
+        std::uint64_t iterations = 1;
+        for (;;) {
+            std::uint64_t allocs = BenchAlloc::count();
+            std::uint64_t bytes = BenchAlloc::bytes();
+            auto started = std::chrono::steady_clock::now();
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                op();
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+            if (seconds >= minSeconds || iterations >= (1ull << 40)) {
+                BenchResult r;
+                r.name = name;
+                r.iterations = iterations;
+                r.itemsPerOp = itemsPerOp;
+                r.nsPerOp = seconds * 1e9 / static_cast<double>(iterations);
+                r.allocsPerOp = static_cast<double>(BenchAlloc::count() - allocs) / static_cast<double>(iterations);
+                r.bytesPerOp = static_cast<double>(BenchAlloc::bytes() - bytes) / static_cast<double>(iterations);
+                add(r);
+                return;
+            }
+            // Aim straight for minSeconds, with headroom, growing at most 100x
+            double scale = seconds > 0.0 ? 1.2 * minSeconds / seconds : 100.0;
+            if (scale > 100.0) scale = 100.0;
+            if (scale < 2.0) scale = 2.0;
+            iterations = static_cast<std::uint64_t>(static_cast<double>(iterations) * scale);
+        }
+    }
+
+    void add(const BenchResult& result);
+    const std::vector<BenchResult>& getResults() const { return results; }
+
+    bool writeJson(const std::string& path, std::string& error) const;
+
+private:
+    std::string filter;
+    double minSeconds;
+    std::vector<BenchResult> results;
+};
+
+#endif // BENCH_H
@@ -0,0 +1,15 @@
+# Micro-benchmarks for the pump core, no Qt required.
+TEMPLATE = app
+TARGET = pumpcore-bench
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../core/pumpcore.pri)
+
+SOURCES += \
+    Bench.cpp \
+    main.cpp
+
+HEADERS += \
+    Bench.h
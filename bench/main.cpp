@@ -0,0 +1,555 @@
+#include "AgpReport.h"
+#include "Bench.h"
+#include "BolusCalculator.h"
+#include "BolusPreview.h"
+#include "CarbAbsorption.h"
+#include "CohortAlerts.h"
+#include "ControlIQ.h"
+#include "GlucoseEstimator.h"
+#include "HistoryManager.h"
+#include "ProfileStore.h"
+#include "PumpSimulation.h"
+#include "StringUtil.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief A typical single-segment profile for the pump benchmarks.
+ */
+UserProfile benchProfile()
+{
+    UserProfile p;
+    p.name = "bench";
+    p.basalRate = 0.8;
+    p.carbRatio = 10.0;
+    p.correctionFactor = 2.0;
+    p.targetGlucose = 6.0;
+    p.segments.push_back({ 6 * 60, { 1.0, 8.0, 2.0, 6.0 } });
+    return p;
+}
+
+/**
+ * @brief The per-tick paths: CGM tick, the full pump step (what the
+ * CgmSimulator timer runs) and PumpEngine::onCgmUpdated on its own,
+ * which includes Control-IQ. The stateful ones run a simulated day on
+ * a fresh pump per op, since history grows with every reading; the
+ * scripted day adds a Scenario with three meals and physiology.
+ */
+void benchTick(BenchSuite& suite)
+{
+    SimClock clock;
+    CgmModel cgm(&clock, 1);
+    suite.run("CgmModel::tick", 1, [&] { benchKeep(cgm.tick()); });
+
+    const int day = 288;
+    suite.run("PumpSimulation::step/day", day, [&] {
+        PumpSimulation sim(1);
+        sim.getProfileManager().loadProfile(benchProfile());
+        for (int t = 0; t < day; ++t) benchKeep(sim.step());
+    });
+
+    auto scenario = std::make_shared<Scenario>();
+    std::string error;
+    Scenario::parse("loop\n"
+                    "at 07:30\neat 45\nmeal-bolus 45\n"
+                    "at 12:30\neat 70\nmeal-bolus 70 extended 40% 3h\nwait until bg < 5 timeout 180\neat 15\n"
+                    "at 19:00\neat 60\nmeal-bolus 60\n"
+                    "repeat\n", *scenario, error);
+    suite.run("PumpSimulation::step/day/scripted", day, [&] {
+        PumpSimulation sim(1);
+        sim.getProfileManager().loadProfile(benchProfile());
+        sim.setScenario(scenario);
+        for (int t = 0; t < day; ++t) benchKeep(sim.step());
+    });
+
+    for (ControllerKind kind : { ControllerKind::Threshold, ControllerKind::Pid, ControllerKind::Mpc }) {
+        suite.run(std::string("PumpEngine::onCgmUpdated/day/") + controllerName(kind), day, [&] {
+            PumpSimulation sim(1);
+            sim.getProfileManager().loadProfile(benchProfile());
+            sim.getPumpEngine().setController(kind);
+            CgmModel& model = sim.getCgmModel();
+            for (int t = 0; t < day; ++t) {
+                sim.getPumpEngine().onCgmUpdated(model.tick());
+            }
+        });
+    }
+}
+
+/**
+ * @brief Checkpoint, restore and fork of a pump with 30 simulated days
+ * behind it. A fork plus one step includes the copy-on-write of the
+ * shared history page.
+ */
+void benchCheckpoint(BenchSuite& suite)
+{
+    if (!suite.selected("PumpSimulation::checkpoint/30d") && !suite.selected("PumpSimulation::restore/30d")
+        && !suite.selected("PumpSimulation::fork+step/30d")) {
+        return;
+    }
+    PumpSimulation sim(1);
+    sim.getProfileManager().loadProfile(benchProfile());
+    for (int t = 0; t < 30 * 288; ++t) sim.step();
+
+    const std::string image = sim.checkpoint();
+    suite.run("PumpSimulation::checkpoint/30d", 1, [&] { benchKeep(sim.checkpoint().size()); });
+
+    PumpSimulation target(2);
+    std::string error;
+    suite.run("PumpSimulation::restore/30d", 1, [&] { benchKeep(target.restore(image, error)); });
+
+    suite.run("PumpSimulation::fork+step/30d", 1, [&] {
+        std::unique_ptr<PumpSimulation> branch = sim.fork();
+        benchKeep(branch->step());
+    });
+}
+
+/**
+ * @brief A full what-if preview: fork per dose, five hours ahead on
+ * worker threads, until the curves are handed back (the latency the
+ * bolus dialog sees).
+ */
+void benchPreview(BenchSuite& suite)
+{
+    if (!suite.selected("BolusPreview::start+wait/4 doses")) return;
+    PumpSimulation sim(11);
+    sim.getProfileManager().loadProfile(benchProfile());
+    for (int t = 0; t < 288; ++t) sim.step();
+
+    BolusPreview preview;
+    const auto candidates = BolusPreview::standardCandidates(4.0);
+    std::mutex mutex;
+    std::condition_variable ready;
+    suite.run("BolusPreview::start+wait/4 doses", 1, [&] {
+        bool done = false;
+        preview.start(sim, candidates, 60.0, BolusPreview::defaultHorizonMinutes,
+                      [&](std::uint64_t, std::vector<BolusPreview::Curve> curves) {
+                          std::lock_guard<std::mutex> lock(mutex);
+                          benchKeep(curves.size());
+                          done = true;
+                          ready.notify_one();
+                      });
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [&] { return done; });
+    });
+}
+
+/**
+ * @brief HistoryManager::addRecord into a fresh log, 1000 records per
+ * op (about three days of CGM readings).
+ */
+void benchHistory(BenchSuite& suite)
+{
+    const int n = 1000;
+    suite.run("HistoryManager::addRecord", n, [&] {
+        HistoryManager history;
+        for (int i = 0; i < n; ++i) {
+            history.addRecord({ SimTime::fromMinutes(5 * i), RecordType::CgmReading, 0.0, "CGM BG = 7.4 mmol/L", 1 });
+        }
+        benchKeep(history.getRecords().size());
+    });
+}
+
+/**
+ * @brief The Qt-free part of the history views' table rebuilds: every
+ * cell of HistoryDialog and the warning filter of AlertDialog, as
+ * strings, over a 2000-record log.
+ */
+void benchHistoryViews(BenchSuite& suite)
+{
+    HistoryManager history;
+    for (int i = 0; i < 2000; ++i) {
+        RecordType type = i % 20 == 0 ? RecordType::Warning
+                        : i % 7 == 0  ? RecordType::AutoBolus
+                                      : RecordType::CgmReading;
+        history.addRecord({ SimTime::fromMinutes(5 * i), type, type == RecordType::AutoBolus ? 1.0 : 0.0,
+                            "CGM BG = 7.4 mmol/L", 1 });
+    }
+    const auto& records = history.getRecords();
+    std::vector<std::string> cells(records.size() * 4);
+
+    suite.run("HistoryDialog::updateTable/rows", static_cast<double>(records.size()), [&] {
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            const HistoryRecord& rec = records[i];
+            cells[i * 4] = formatSimTime(rec.getTime());
+            cells[i * 4 + 1] = recordTypeName(rec.getRecordType());
+            cells[i * 4 + 2] = rec.getInsulinAmount() > 0 ? formatFixed(rec.getInsulinAmount(), 2) : "-";
+            cells[i * 4 + 3] = rec.getNotes();
+        }
+        benchKeep(cells);
+    });
+
+    std::vector<const HistoryRecord*> warnings;
+    suite.run("AlertDialog::updateAlerts/rows", static_cast<double>(records.size()), [&] {
+        warnings.clear();
+        for (const HistoryRecord& rec : records) {
+            if (rec.getRecordType() == RecordType::Warning) warnings.push_back(&rec);
+        }
+        for (std::size_t i = 0; i < warnings.size(); ++i) {
+            cells[i * 2] = formatSimTime(warnings[i]->getTime());
+            cells[i * 2 + 1] = warnings[i]->getNotes();
+        }
+        benchKeep(cells);
+    });
+}
+
+/**
+ * @brief BolusSafetyManager::canDeliverBolus with a day of boluses in
+ * the rolling window, one allowed and one blocked amount.
+ */
+void benchSafety(BenchSuite& suite)
+{
+    SimClock clock;
+    BolusSafetyManager safety(&clock);
+    for (int i = 0; i < 8; ++i) {
+        safety.recordBolus(2.0);
+        clock.advance(180);
+    }
+
+    std::string error;
+    suite.run("BolusSafetyManager::canDeliverBolus/ok", 1, [&] {
+        benchKeep(safety.canDeliverBolus(2.0, error));
+    });
+    suite.run("BolusSafetyManager::canDeliverBolus/blocked", 1, [&] {
+        benchKeep(safety.canDeliverBolus(25.0, error));
+    });
+}
+
+/**
+ * @brief What BolusDeliveryWidget::calculateSuggestedBolus does: look up
+ * the settings in force, then the dose formula. Also the batched API.
+ */
+void benchBolusCalculator(BenchSuite& suite)
+{
+    TherapySchedule schedule(benchProfile());
+    SimTime now;
+    suite.run("calculateSuggestedBolus", 1, [&] {
+        now += 5;
+        BolusCalcParams params = BolusCalcParams::fromSettings(schedule.at(now));
+        benchKeep(BolusCalculator::suggestBolus(params, 9.5, 45.0, 1.2, 0.02));
+    });
+
+    const std::size_t n = 100000;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> bgDist(3.0, 18.0);
+    std::uniform_real_distribution<double> carbDist(0.0, 120.0);
+    std::uniform_real_distribution<double> iobDist(0.0, 5.0);
+    std::uniform_real_distribution<double> trendDist(-0.1, 0.1);
+
+    const std::uint32_t profileCount = 64;
+    std::vector<BolusCalcParams> profiles;
+    for (std::uint32_t p = 0; p < profileCount; ++p) {
+        UserProfile prof;
+        prof.carbRatio = 8.0 + p % 8;
+        prof.correctionFactor = 1.5 + (p % 5) * 0.5;
+        prof.targetGlucose = 5.5 + (p % 3) * 0.5;
+        profiles.push_back(BolusCalcParams::fromProfile(prof));
+    }
+
+    std::vector<double> bg(n), carbs(n), iob(n), trend(n), out(n);
+    std::vector<std::uint32_t> ids(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        bg[i] = bgDist(rng);
+        carbs[i] = carbDist(rng);
+        iob[i] = iobDist(rng);
+        trend[i] = trendDist(rng);
+        ids[i] = static_cast<std::uint32_t>(i % profileCount);
+    }
+
+    BolusCalcBatch batch;
+    batch.bg = bg.data();
+    batch.carbs = carbs.data();
+    batch.iob = iob.data();
+    batch.trend = trend.data();
+    batch.count = n;
+
+    suite.run("suggestBoluses/single-profile", static_cast<double>(n), [&] {
+        batch.profileId = nullptr;
+        BolusCalculator::suggestBoluses(profiles.data(), batch, out.data());
+        benchKeep(out);
+    });
+    suite.run("suggestBoluses/per-row-profile", static_cast<double>(n), [&] {
+        batch.profileId = ids.data();
+        BolusCalculator::suggestBoluses(profiles.data(), batch, out.data());
+        benchKeep(out);
+    });
+}
+
+/**
+ * @brief Saves a library of n virtual-patient profiles, then times
+ * ProfileStore::open (index only) and a name lookup plus record read.
+ */
+void benchProfileStore(BenchSuite& suite, std::size_t n)
+{
+    if (!suite.selected("ProfileStore")) return;
+
+    const std::string path = "pumpcore-bench-profiles.bin";
+    std::string error;
+    {
+        ProfileStore store;
+        for (std::size_t i = 0; i < n; ++i) {
+            UserProfile p;
+            p.name = "patient-" + std::to_string(i);
+            p.basalRate = 0.5 + (i % 20) * 0.05;
+            p.carbRatio = 8.0 + i % 8;
+            p.correctionFactor = 1.5 + (i % 5) * 0.5;
+            p.targetGlucose = 6.0;
+            if (i % 4 == 0) {
+                p.segments.push_back({ 6 * 60, { p.basalRate * 1.2, p.carbRatio, p.correctionFactor, 6.0 } });
+                p.segments.push_back({ 22 * 60, { p.basalRate * 0.8, p.carbRatio, p.correctionFactor, 6.5 } });
+            }
+            store.add(p);
+        }
+        if (!store.save(path, error)) {
+            std::fprintf(stderr, "profile store save failed: %s\n", error.c_str());
+            return;
+        }
+    }
+
+    suite.run("ProfileStore::open/" + std::to_string(n), static_cast<double>(n), [&] {
+        ProfileStore store;
+        benchKeep(store.open(path, error));
+    });
+
+    ProfileStore store;
+    store.open(path, error);
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < 1024; ++i) {
+        names.push_back("patient-" + std::to_string((i * 7919) % n));
+    }
+    std::size_t next = 0;
+    suite.run("ProfileStore::findByName+get", 1, [&] {
+        long long slot = store.findByName(names[next++ % names.size()]);
+        benchKeep(store.get(static_cast<std::size_t>(slot)).basalRate);
+    });
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief GlucoseEstimator::update over a noisy sine trace.
+ */
+void benchGlucoseEstimator(BenchSuite& suite)
+{
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 0.2);
+    std::vector<double> bg(4096);
+    for (std::size_t i = 0; i < bg.size(); ++i) {
+        bg[i] = 8.0 + 4.0 * std::sin(i * 0.02) + noise(rng);
+    }
+
+    GlucoseEstimator est;
+    std::size_t next = 0;
+    suite.run("GlucoseEstimator::update", 1, [&] {
+        est.update(bg[next++ & (bg.size() - 1)], 5.0);
+        benchKeep(est);
+    });
+}
+
+/**
+ * @brief CarbAbsorption::advance per CGM tick with a full meal pool: a
+ * meal finishing absorption is replaced at once, so every op walks
+ * maxMeals meals of mixed speeds and ages.
+ */
+void benchCarbAbsorption(BenchSuite& suite)
+{
+    CarbAbsorption carbs;
+    int eaten = 0;
+    auto topUp = [&] {
+        while (carbs.getActiveMeals() < CarbAbsorption::maxMeals) {
+            carbs.addMeal(20.0 + eaten % 50, static_cast<AbsorptionSpeed>(eaten % CarbAbsorption::speedCount));
+            ++eaten;
+        }
+    };
+    topUp();
+    suite.run("CarbAbsorption::advance/meals", CarbAbsorption::maxMeals, [&] {
+        benchKeep(carbs.advance(CgmModel::minutesPerTick));
+        topUp();
+    });
+}
+
+/**
+ * @brief Deterministic BG scenarios for the controller benchmark:
+ * a post-meal rise, an overnight fall and a slow sine drift.
+ */
+double scenarioBg(int scenario, int tick)
+{
+    switch (scenario) {
+    case 0:  return 6.0 + 8.0 * std::exp(-std::pow((tick - 24) / 18.0, 2.0));
+    case 1:  return std::max(3.0, 9.0 - 0.04 * tick);
+    default: return 8.0 + 4.0 * std::sin(tick * 0.05);
+    }
+}
+
+/**
+ * @brief Times decideBatch for one policy type over n patients. Inputs
+ * come from the scenarios run through an estimator, captured at a few
+ * points of the day and cycled, so policy state keeps evolving.
+ */
+template <class Policy>
+void benchController(BenchSuite& suite, ControllerKind kind, std::size_t n)
+{
+    const std::string name = std::string("decideBatch/") + controllerName(kind);
+    if (!suite.selected(name)) return;
+
+    std::vector<Policy> policies;
+    policies.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        policies.push_back(std::get<Policy>(makeController(kind)));
+    }
+
+    const int snapshots = 8;
+    std::vector<ControllerInput> inputs(n * snapshots);
+    std::vector<GlucoseEstimator> estimators(n);
+    for (int t = 0; t < 288; ++t) {
+        for (std::size_t i = 0; i < n; ++i) {
+            double bg = scenarioBg(static_cast<int>(i % 3), t + static_cast<int>(i % 37));
+            GlucoseEstimator& est = estimators[i];
+            est.update(bg, 5.0);
+            if (t % 36 != 35) continue;
+
+            ControllerInput& in = inputs[(t / 36) * n + i];
+            in.bg = est.smoothedBg();
+            in.trend = est.rateOfChange();
+            in.hasTrend = est.hasTrend();
+            in.insulinOnBoard = 0.5 * (i % 4);
+            in.settings = { 0.6 + (i % 10) * 0.05, 10.0, 2.0, 6.0 };
+        }
+    }
+
+    std::vector<ControllerDecision> out(n);
+    int snapshot = 0;
+    suite.run(name, static_cast<double>(n), [&] {
+        decideBatch(policies.data(), inputs.data() + (snapshot++ % snapshots) * n, n, out.data());
+        benchKeep(out);
+    });
+}
+
+/**
+ * @brief Times one CohortAlerts pass over n patients. BG columns for a
+ * few ticks of a slow sine per patient are precomputed and cycled, so
+ * a small share of patients crosses a threshold each pass; the
+ * reservoir and battery sit well above theirs.
+ */
+void benchCohortAlerts(BenchSuite& suite, std::size_t n)
+{
+    if (!suite.selected("CohortAlerts::evaluate")) return;
+    const int snapshots = 32;
+    std::vector<double> bg(n * snapshots), reservoir(n, 150.0), battery(n, 60.0);
+    for (int t = 0; t < snapshots; ++t) {
+        for (std::size_t i = 0; i < n; ++i) {
+            bg[t * n + i] = 8.0 + 5.0 * std::sin((t + static_cast<double>(i % 97) * 0.7) * 0.2);
+        }
+    }
+    CohortAlerts alerts(n);
+    std::vector<AlertTransition> out;
+    long long tick = 0;
+    suite.run("CohortAlerts::evaluate", static_cast<double>(n), [&] {
+        const AlertLevels levels { bg.data() + (tick % snapshots) * n, reservoir.data(), battery.data(), n };
+        out.clear();
+        alerts.evaluate(levels, SimTime::fromMinutes(5 * tick++), out);
+        benchKeep(out.size());
+    });
+}
+
+/**
+ * @brief Times feeding one tick of readings for n patients into an
+ * AgpReport (each patient's profile and the cohort's), over two weeks of
+ * ticks so the cohort sketches are compacting, then one full-day cohort
+ * AGP report.
+ */
+void benchAgp(BenchSuite& suite, std::size_t n)
+{
+    const bool addSelected = suite.selected("AgpReport::addTick");
+    const bool reportSelected = suite.selected("AgpProfile::report");
+    if (!addSelected && !reportSelected) return;
+
+    const int snapshots = 32;
+    std::vector<double> bg(n * snapshots);
+    std::mt19937 rng(7);
+    std::lognormal_distribution<double> level(2.0, 0.35);
+    for (double& v : bg) v = level(rng);
+
+    AgpReport report(n);
+    long long tick = 0;
+    auto addTick = [&] {
+        report.addTick(bg.data() + (tick % snapshots) * n, n, SimTime::fromMinutes(5 * tick));
+        ++tick;
+    };
+    for (int t = 0; t < 14 * 288; ++t) addTick();
+
+    if (addSelected) {
+        suite.run("AgpReport::addTick", static_cast<double>(n), addTick);
+    }
+    if (reportSelected) {
+        std::vector<AgpBin> out;
+        suite.run("AgpProfile::report", static_cast<double>(AgpProfile::binCount), [&] {
+            report.cohort().report(out);
+            benchKeep(out[0].p50);
+        });
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Micro-benchmarks for the pump's hot paths.
+ *
+ * Usage: pumpcore-bench [--json PATH] [--filter SUBSTRING] [--min-time SECONDS]
+ *
+ * Prints one line per benchmark; --json also writes the results (ns/op,
+ * ns/item, allocations and bytes per op) for tracking across releases.
+ */
+int main(int argc, char *argv[])
+{
+    std::string jsonPath;
+    std::string filter;
+    double minSeconds = 0.2;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minSeconds = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--json PATH] [--filter SUBSTRING] [--min-time SECONDS]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    BenchSuite suite(filter, minSeconds);
+    benchTick(suite);
+    benchHistory(suite);
+    benchHistoryViews(suite);
+    benchCheckpoint(suite);
+    benchPreview(suite);
+    benchSafety(suite);
+    benchBolusCalculator(suite);
+    benchProfileStore(suite, 100000);
+    benchGlucoseEstimator(suite);
+    benchCarbAbsorption(suite);
+    benchController<ThresholdPolicy>(suite, ControllerKind::Threshold, 10000);
+    benchController<PidPolicy>(suite, ControllerKind::Pid, 10000);
+    benchController<MpcPolicy>(suite, ControllerKind::Mpc, 10000);
+    benchCohortAlerts(suite, 10000);
+    benchAgp(suite, 1000);
+
+    if (!jsonPath.empty()) {
+        std::string error;
+        if (!suite.writeJson(jsonPath, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "AgpReport.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double agpQuantiles[] = { 0.05, 0.25, 0.50, 0.75, 0.95 };
+
+AgpBin toBin(const QuantileSketch& sketch)
+{
+    AgpBin b;
+    b.readings = sketch.count();
+    double q[5];
+    sketch.quantiles(agpQuantiles, 5, q);
+    b.p5 = q[0];
+    b.p25 = q[1];
+    b.p50 = q[2];
+    b.p75 = q[3];
+    b.p95 = q[4];
+    return b;
+}
+
+} // namespace
+
+AgpProfile::AgpProfile(int k)
+    : bins(binCount, QuantileSketch(k))
+{
+}
+
+void AgpProfile::add(SimTime time, double bg)
+{
+    if (std::isnan(bg)) return;
+    bins[binOf(time)].add(static_cast<float>(bg));
+}
+
+void AgpProfile::merge(const AgpProfile& other)
+{
+    for (int i = 0; i < binCount; ++i) {
+        bins[i].merge(other.bins[i]);
+    }
+}
+
+void AgpProfile::clear()
+{
+    for (QuantileSketch& s : bins) s.clear();
+}
+
+std::uint64_t AgpProfile::count() const
+{
+    std::uint64_t total = 0;
+    for (const QuantileSketch& s : bins) total += s.count();
+    return total;
+}
+
+AgpBin AgpProfile::bin(int index, int span) const
+{
+    index = ((index % binCount) + binCount) % binCount;
+    if (span <= 1) return toBin(bins[index]);
+
+    QuantileSketch pooled = bins[index];
+    for (int i = 1; i < span && i < binCount; ++i) {
+        pooled.merge(bins[(index + i) % binCount]);
+    }
+    return toBin(pooled);
+}
+
+void AgpProfile::report(std::vector<AgpBin>& out) const
+{
+    out.resize(binCount);
+    for (int i = 0; i < binCount; ++i) {
+        out[i] = toBin(bins[i]);
+    }
+}
+
+AgpReport::AgpReport(std::size_t patients, int k)
+    : k(k), all(k)
+{
+    resize(patients);
+}
+
+void AgpReport::resize(std::size_t count)
+{
+    patients.resize(count, AgpProfile(k));
+}
+
+void AgpReport::add(std::size_t patient, SimTime time, double bg)
+{
+    patients[patient].add(time, bg);
+    all.add(time, bg);
+}
+
+std::size_t AgpReport::addTick(const double* bg, std::size_t count, SimTime time)
+{
+    const std::size_t n = std::min(count, patients.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        add(i, time, bg[i]);
+    }
+    return n;
+}
+
+void AgpReport::clear()
+{
+    for (AgpProfile& p : patients) p.clear();
+    all.clear();
+}
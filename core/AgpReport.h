@@ -0,0 +1,104 @@
+#ifndef AGPREPORT_H
+#define AGPREPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "QuantileSketch.h"
+#include "SimTime.h"
+
+/**
+ * @brief The Ambulatory Glucose Profile percentiles for one slot of the
+ * day, in mmol/L.
+ */
+struct AgpBin {
+    std::uint64_t readings = 0;
+    double p5 = 0.0;
+    double p25 = 0.0;
+    double p50 = 0.0;
+    double p75 = 0.0;
+    double p95 = 0.0;
+};
+
+/**
+ * @brief AgpProfile is one Ambulatory Glucose Profile: a QuantileSketch
+ * of CGM readings for each 5-minute slot of the day, over any number of
+ * days. Adding a reading is one sketch insert, memory is bounded by the
+ * sketches however long the record, and profiles merge slot by slot.
+ */
+class AgpProfile
+{
+public:
+    static constexpr int binMinutes = 5;
+    static constexpr int binCount = static_cast<int>(SimTime::minutesPerDay / binMinutes);
+
+    explicit AgpProfile(int k = QuantileSketch::defaultK);
+
+    static int binOf(SimTime time) { return time.minuteOfDay() / binMinutes; }
+
+    /**
+     * @brief add records a reading (mmol/L) taken at time; NaN (no
+     * reading) is ignored.
+     */
+    void add(SimTime time, double bg);
+    void merge(const AgpProfile& other);
+    void clear();
+
+    std::uint64_t count() const;
+
+    /**
+     * @brief Percentiles for slot bin, pooled with the following slots
+     * when span > 1 (wrapping past midnight), e.g. span 12 for an hour.
+     */
+    AgpBin bin(int index, int span = 1) const;
+
+    /**
+     * @brief report fills out with every slot of the day (binCount entries).
+     */
+    void report(std::vector<AgpBin>& out) const;
+
+    const QuantileSketch& sketch(int index) const { return bins[index]; }
+
+private:
+    std::vector<QuantileSketch> bins;   // binCount, by time of day
+};
+
+/**
+ * @brief AgpReport keeps an AgpProfile per patient and one for the whole
+ * cohort, fed together, so either AGP is available at any time without
+ * merging or sorting the history.
+ */
+class AgpReport
+{
+public:
+    explicit AgpReport(std::size_t patients = 0, int k = QuantileSketch::defaultK);
+
+    /**
+     * @brief resize keeps the profiles of the first patients; new ones
+     * start empty. The cohort profile keeps everything added so far.
+     */
+    void resize(std::size_t patients);
+    std::size_t size() const { return patients.size(); }
+
+    void add(std::size_t patient, SimTime time, double bg);
+
+    /**
+     * @brief addTick records one reading per patient (bg[i] for patient
+     * i), all taken at time. count should equal size(); if it does not,
+     * the first min(count, size()) readings are still recorded.
+     * @return the number of readings recorded
+     */
+    std::size_t addTick(const double* bg, std::size_t count, SimTime time);
+
+    const AgpProfile& patient(std::size_t index) const { return patients[index]; }
+    const AgpProfile& cohort() const { return all; }
+
+    void clear();
+
+private:
+    int k;
+    std::vector<AgpProfile> patients;
+    AgpProfile all;
+};
+
+#endif // AGPREPORT_H
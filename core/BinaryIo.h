@@ -0,0 +1,79 @@
+#ifndef BINARYIO_H
+#define BINARYIO_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+ * @brief BinaryWriter appends fixed-size values and length-prefixed
+ * strings to a byte buffer, in host byte order (little-endian on every
+ * target we build). Used by ProfileStore and simulation checkpoints.
+ */
+class BinaryWriter
+{
+public:
+    explicit BinaryWriter(std::string& out) : out(out) {}
+
+    template <typename T>
+    void put(T value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putBytes(const char* data, std::size_t n) { out.append(data, n); }
+
+    /**
+     * @brief putString writes a u32 length, then the bytes.
+     */
+    void putString(const std::string& s)
+    {
+        put<std::uint32_t>(static_cast<std::uint32_t>(s.size()));
+        out.append(s);
+    }
+
+private:
+    std::string& out;
+};
+
+/**
+ * @brief Bounds-checked cursor over a byte buffer; every get fails
+ * rather than reading past the end.
+ */
+class BinaryReader
+{
+public:
+    BinaryReader(const char* data, std::size_t size) : data(data), size(size), pos(0) {}
+
+    template <typename T>
+    bool get(T& value)
+    {
+        if (size - pos < sizeof(T)) return false;
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool getBytes(std::string& out, std::size_t n)
+    {
+        if (size - pos < n) return false;
+        out.assign(data + pos, n);
+        pos += n;
+        return true;
+    }
+
+    bool getString(std::string& out)
+    {
+        std::uint32_t len = 0;
+        return get(len) && getBytes(out, len);
+    }
+
+    bool atEnd() const { return pos == size; }
+
+private:
+    const char* data;
+    std::size_t size;
+    std::size_t pos;
+};
+
+#endif // BINARYIO_H
@@ -0,0 +1,94 @@
+#include "BolusCalculator.h"
+#include <algorithm>
+#include <limits>
+
+BolusCalcParams BolusCalcParams::fromSettings(const TherapySettings& settings)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    BolusCalcParams p;
+    p.carbRatio        = settings.carbRatio > 0.0 ? settings.carbRatio : inf;
+    p.correctionFactor = settings.correctionFactor > 0.0 ? settings.correctionFactor : inf;
+    p.targetGlucose    = settings.targetGlucose;
+    return p;
+}
+
+BolusCalcParams BolusCalcParams::fromProfile(const UserProfile& profile)
+{
+    return fromSettings(profile.baseSettings());
+}
+
+namespace BolusCalculator {
+
+namespace {
+
+inline double dose(double carbRatio, double correctionFactor, double target,
+                   double bg, double carbs, double iob, double trend, double carbsOnBoard)
+{
+    double projected = bg + trend * trendHorizonMinutes;
+    double foodBolus = carbs / carbRatio;
+    double correction = std::max(projected - target, 0.0) / correctionFactor;
+    // Net IOB goes negative after a suspension; that never adds insulin
+    iob = std::max(iob, 0.0);
+    double spoken = std::min(carbsOnBoard / carbRatio, iob);
+    return std::max(foodBolus + correction - (iob - spoken), 0.0);
+}
+
+/**
+ * @brief One profile for every row: hoisted so the loop is pure SIMD.
+ * The optional columns are template flags, not per-row tests.
+ */
+template <bool HasTrend, bool HasCarbsOnBoard>
+void uniformDoses(const BolusCalcParams& p, const BolusCalcBatch& batch, double* out)
+{
+    const double* bg = batch.bg;
+    const double* carbs = batch.carbs;
+    const double* iob = batch.iob;
+    const double* trend = batch.trend;
+    const double* cob = batch.carbsOnBoard;
+    const double cr = p.carbRatio;
+    const double cf = p.correctionFactor;
+    const double tg = p.targetGlucose;
+    for (std::size_t i = 0; i < batch.count; ++i) {
+        out[i] = dose(cr, cf, tg, bg[i], carbs[i], iob[i],
+                      HasTrend ? trend[i] : 0.0, HasCarbsOnBoard ? cob[i] : 0.0);
+    }
+}
+
+} // namespace
+
+double suggestBolus(const BolusCalcParams& params,
+                    double bg, double carbs, double iob, double trend,
+                    double carbsOnBoard)
+{
+    return dose(params.carbRatio, params.correctionFactor, params.targetGlucose,
+                bg, carbs, iob, trend, carbsOnBoard);
+}
+
+void suggestBoluses(const BolusCalcParams* profiles,
+                    const BolusCalcBatch& batch,
+                    double* out)
+{
+    const double* bg = batch.bg;
+    const double* carbs = batch.carbs;
+    const double* iob = batch.iob;
+    const double* trend = batch.trend;
+    const double* cob = batch.carbsOnBoard;
+    const std::size_t n = batch.count;
+
+    if (!batch.profileId) {
+        if (trend && cob)  uniformDoses<true, true>(profiles[0], batch, out);
+        else if (trend)    uniformDoses<true, false>(profiles[0], batch, out);
+        else if (cob)      uniformDoses<false, true>(profiles[0], batch, out);
+        else               uniformDoses<false, false>(profiles[0], batch, out);
+        return;
+    }
+
+    const std::uint32_t* id = batch.profileId;
+    for (std::size_t i = 0; i < n; ++i) {
+        const BolusCalcParams& p = profiles[id[i]];
+        out[i] = dose(p.carbRatio, p.correctionFactor, p.targetGlucose,
+                      bg[i], carbs[i], iob[i], trend ? trend[i] : 0.0, cob ? cob[i] : 0.0);
+    }
+}
+
+} // namespace BolusCalculator
@@ -0,0 +1,64 @@
+#ifndef BOLUSCALCULATOR_H
+#define BOLUSCALCULATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include "UserProfile.h"
+
+/**
+ * @brief BolusCalcParams is the part of a profile the dose formula uses,
+ * prepared once so the per-dose math is branch-free: a ratio that is not
+ * set (<= 0) becomes infinity, which turns its term into 0.
+ */
+struct BolusCalcParams {
+    double carbRatio;         // grams per 1U, or +inf
+    double correctionFactor;  // mmol/L per 1U, or +inf
+    double targetGlucose;     // mmol/L
+
+    static BolusCalcParams fromSettings(const TherapySettings& settings);
+    static BolusCalcParams fromProfile(const UserProfile& profile);
+};
+
+/**
+ * @brief Structure-of-arrays input for suggestBoluses. trend,
+ * carbsOnBoard and profileId may be null (no trend / no carbs on board /
+ * every row uses profile 0).
+ */
+struct BolusCalcBatch {
+    const double* bg = nullptr;          // mmol/L
+    const double* carbs = nullptr;       // g
+    const double* iob = nullptr;         // U
+    const double* trend = nullptr;       // mmol/L per minute
+    const double* carbsOnBoard = nullptr;   // g
+    const std::uint32_t* profileId = nullptr;
+    std::size_t count = 0;
+};
+
+/**
+ * @brief The bolus formula:
+ * Suggested Dose = Carbs / CarbRatio + (BG' - Target) / CorrectionFactor - IOB,
+ * where BG' is BG projected trendHorizonMinutes ahead along the trend,
+ * the correction is only applied above target, and the dose is never below 0.
+ * IOB below 0 (net IOB after a suspension) counts as 0.
+ * Insulin on board that earlier meals' carbs still on board will use up
+ * (COB / CarbRatio, at most the IOB) is not subtracted: it is spoken for.
+ */
+namespace BolusCalculator {
+
+constexpr double trendHorizonMinutes = 30.0;
+
+double suggestBolus(const BolusCalcParams& params,
+                    double bg, double carbs, double iob, double trend = 0.0,
+                    double carbsOnBoard = 0.0);
+
+/**
+ * @brief suggestBoluses computes batch.count doses into out in one pass.
+ * With no profileId column the loop has no gathers and auto-vectorises.
+ */
+void suggestBoluses(const BolusCalcParams* profiles,
+                    const BolusCalcBatch& batch,
+                    double* out);
+
+} // namespace BolusCalculator
+
+#endif // BOLUSCALCULATOR_H
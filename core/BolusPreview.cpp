@@ -0,0 +1,126 @@
+#include "BolusPreview.h"
+#include "PumpSimulation.h"
+#include "StringUtil.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+
+struct BolusPreview::Job {
+    std::uint64_t request = 0;
+    std::atomic<bool> cancelled { false };
+    std::atomic<int> remaining { 0 };
+    std::vector<std::unique_ptr<PumpSimulation>> forks;
+    std::vector<Candidate> candidates;
+    std::vector<Curve> curves;
+    double carbs = 0.0;
+    int horizonMinutes = 0;
+    Callback done;
+};
+
+BolusPreview::~BolusPreview()
+{
+    cancel();
+}
+
+std::vector<BolusPreview::Candidate> BolusPreview::standardCandidates(double suggested,
+                                                                      double extendedFraction,
+                                                                      int extendedHours)
+{
+    // Doses are rounded to the pump's 0.05 U resolution
+    auto round = [](double units) { return std::max(0.0, std::round(units * 20.0) / 20.0); };
+    double dose = round(suggested);
+
+    std::vector<Candidate> out;
+    auto addDose = [&out](const std::string& label, double units, double fraction, int hours) {
+        for (const Candidate& c : out) {
+            if (c.units == units && c.extendedFraction == fraction) return;
+        }
+        out.push_back({ label, units, fraction, hours });
+    };
+    addDose("Suggested " + formatFixed(dose, 2) + " U", dose, 0.0, 0);
+    addDose("-20% " + formatFixed(round(dose * 0.8), 2) + " U", round(dose * 0.8), 0.0, 0);
+    addDose("+20% " + formatFixed(round(dose * 1.2), 2) + " U", round(dose * 1.2), 0.0, 0);
+    if (dose > 0.0 && extendedFraction > 0.0 && extendedFraction < 1.0 && extendedHours > 0) {
+        addDose("Extended " + formatFixed(extendedFraction * 100.0, 0) + "% over "
+                    + std::to_string(extendedHours) + "h",
+                dose, extendedFraction, extendedHours);
+    }
+    return out;
+}
+
+BolusPreview::Curve BolusPreview::project(PumpSimulation& sim, const Candidate& candidate, double carbs,
+                                          int horizonMinutes, const std::atomic<bool>& cancelled)
+{
+    PUMP_TRACE_SCOPE("preview", "BolusPreview::project");
+    Curve curve;
+    curve.label = candidate.label;
+    curve.units = candidate.units;
+
+    PumpEngine& engine = sim.getPumpEngine();
+    CgmModel& cgm = sim.getCgmModel();
+    if (candidate.units > 0.0
+        && !engine.requestBolus(candidate.units, "Preview", candidate.extendedFraction, candidate.extendedHours)) {
+        curve.blocked = true;
+        return curve;
+    }
+
+    // The fork runs its own physiology: the meal is eaten now, alongside
+    // anything its scenario still has planned
+    sim.setPhysiology(true);
+    sim.getCarbs().addMeal(carbs);
+
+    const int steps = horizonMinutes / CgmModel::minutesPerTick;
+    curve.bg.reserve(steps + 1);
+    curve.bg.push_back(cgm.getCurrentBg());
+    for (int i = 0; i < steps; ++i) {
+        if (cancelled.load(std::memory_order_relaxed)) break;
+        curve.bg.push_back(sim.step());
+    }
+    return curve;
+}
+
+std::uint64_t BolusPreview::start(const PumpSimulation& base, const std::vector<Candidate>& candidates,
+                                  double carbs, int horizonMinutes, Callback done)
+{
+    PUMP_TRACE_SCOPE("preview", "BolusPreview::start");
+    cancel();
+
+    auto job = std::make_shared<Job>();
+    job->request = nextRequest++;
+    job->candidates = candidates;
+    job->curves.resize(candidates.size());
+    job->carbs = carbs;
+    job->horizonMinutes = horizonMinutes;
+    job->done = std::move(done);
+    job->remaining = static_cast<int>(candidates.size());
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        job->forks.push_back(base.fork());
+    }
+    current = job;
+
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        workers.emplace_back([job, i] {
+            job->curves[i] = project(*job->forks[i], job->candidates[i], job->carbs,
+                                     job->horizonMinutes, job->cancelled);
+            job->forks[i].reset();
+            // The last worker to finish hands over all curves
+            if (job->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1
+                && !job->cancelled.load(std::memory_order_acquire)) {
+                job->done(job->request, std::move(job->curves));
+            }
+        });
+    }
+    return job->request;
+}
+
+void BolusPreview::cancel()
+{
+    if (current) {
+        current->cancelled.store(true, std::memory_order_release);
+        current.reset();
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    workers.clear();
+}
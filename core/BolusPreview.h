@@ -0,0 +1,94 @@
+#ifndef BOLUSPREVIEW_H
+#define BOLUSPREVIEW_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class PumpSimulation;
+
+/**
+ * @brief BolusPreview answers "what happens if I take this dose?" by
+ * forking the pump (PumpSimulation::fork) once per candidate dose and
+ * running each fork a few hours ahead on its own thread, Control-IQ
+ * included.
+ *
+ * Each fork runs with physiology on (see GlucoseResponse), so the dose
+ * and the meal's carbs move its BG, and a scripted patient's scenario
+ * carries on in the fork. Each fork keeps its parent's CGM noise, so
+ * the curves differ only by the dose.
+ *
+ * start() cancels any preview still running; results arrive through the
+ * callback, on a worker thread, only for previews that were not
+ * cancelled. Each fork sees only its own state, so workers share nothing.
+ */
+class BolusPreview
+{
+public:
+    static constexpr int defaultHorizonMinutes = 300;
+
+    struct Candidate {
+        std::string label;
+        double units = 0.0;
+        double extendedFraction = 0.0;  // as PumpEngine::requestBolus
+        int extendedHours = 0;
+    };
+
+    struct Curve {
+        std::string label;
+        double units = 0.0;
+        bool blocked = false;     // refused by the safety rules; bg is then empty
+        std::vector<double> bg;   // mmol/L every 5 min, starting with the current reading
+    };
+
+    using Callback = std::function<void(std::uint64_t request, std::vector<Curve> curves)>;
+
+    BolusPreview() = default;
+    ~BolusPreview();
+
+    BolusPreview(const BolusPreview&) = delete;
+    BolusPreview& operator=(const BolusPreview&) = delete;
+
+    /**
+     * @brief The usual comparison: the suggested dose, 20% less and 20%
+     * more, and the suggestion split as an extended bolus.
+     * Duplicate doses (e.g. all zero) are left out.
+     */
+    static std::vector<Candidate> standardCandidates(double suggested,
+                                                     double extendedFraction = 0.4,
+                                                     int extendedHours = 3);
+
+    /**
+     * @brief project delivers the candidate into sim (normally a fork) and
+     * runs it horizonMinutes ahead; stops early once cancelled is set.
+     */
+    static Curve project(PumpSimulation& sim, const Candidate& candidate, double carbs,
+                         int horizonMinutes, const std::atomic<bool>& cancelled);
+
+    /**
+     * @brief start forks base (on the calling thread, which must own it)
+     * and projects every candidate in parallel.
+     * @return the request number passed to done
+     */
+    std::uint64_t start(const PumpSimulation& base, const std::vector<Candidate>& candidates,
+                        double carbs, int horizonMinutes, Callback done);
+
+    /**
+     * @brief cancel stops the running preview and waits for its threads;
+     * its callback will not be called.
+     */
+    void cancel();
+
+private:
+    struct Job;
+
+    std::shared_ptr<Job> current;
+    std::vector<std::thread> workers;
+    std::uint64_t nextRequest = 1;
+};
+
+#endif // BOLUSPREVIEW_H
@@ -0,0 +1,100 @@
+#include "BolusSafetyManager.h"
+#include "BinaryIo.h"
+
+BolusSafetyManager::BolusSafetyManager(const SimClock* clock)
+    : rules(defaultSafetyRules, defaultSafetyRuleCount, limits)
+    , simClock(clock)
+    , dailyTotal(bucketMinutes, windowMinutes / bucketMinutes)
+    , hasLastBolus(false)
+{
+}
+
+void BolusSafetyManager::setLimits(const SafetyLimits& newLimits)
+{
+    if (newLimits == limits) return;
+    limits = newLimits;
+    rules = CompiledSafetyRules(defaultSafetyRules, defaultSafetyRuleCount, limits);
+}
+
+BolusCandidate BolusSafetyManager::makeCandidate(double amount)
+{
+    SimTime now = simClock->now();
+
+    BolusCandidate c;
+    c.amount = amount;
+    c.rollingDailyTotal = dailyTotal.total(now);
+    if (hasLastBolus) {
+        c.minutesSinceLastBolus = static_cast<double>(now - lastBolusTime);
+    }
+    return c;
+}
+
+BolusBlockReason BolusSafetyManager::check(const BolusCandidate& candidate) const
+{
+    return rules.evaluate(candidate);
+}
+
+/**
+ * @brief Checks if a new bolus is allowed, with only the pump's own
+ * bolus history known (no BG/IOB/reservoir observations).
+ */
+bool BolusSafetyManager::canDeliverBolus(double amount, std::string &errorMessage)
+{
+    return canDeliverBolus(makeCandidate(amount), errorMessage);
+}
+
+bool BolusSafetyManager::canDeliverBolus(const BolusCandidate& candidate,
+                                         std::string &errorMessage) const
+{
+    BolusBlockReason reason = check(candidate);
+    if (reason == BolusBlockReason::None) {
+        return true;
+    }
+    errorMessage = describeBlockReason(reason, limits, candidate);
+    return false;
+}
+
+/**
+ * @brief Records a delivered bolus in the rolling 24h total
+ * and updates lastBolusTime.
+ */
+void BolusSafetyManager::recordBolus(double amount)
+{
+    lastBolusTime = simClock->now();
+    dailyTotal.add(lastBolusTime, amount);
+    hasLastBolus = true;
+}
+
+double BolusSafetyManager::getRollingDailyTotal()
+{
+    return dailyTotal.total(simClock->now());
+}
+
+void BolusSafetyManager::saveState(BinaryWriter& out) const
+{
+    out.put(limits.maxSingleBolus);
+    out.put(limits.maxDailyBolus);
+    out.put(limits.cooldownMinutes);
+    out.put(limits.maxInsulinOnBoard);
+    out.put(limits.bgLockout);
+    dailyTotal.saveState(out);
+    out.put<std::uint8_t>(hasLastBolus ? 1 : 0);
+    out.put<std::int64_t>(lastBolusTime.minutes());
+}
+
+bool BolusSafetyManager::restoreState(BinaryReader& in)
+{
+    SafetyLimits saved;
+    std::uint8_t savedHasLast = 0;
+    std::int64_t savedLast = 0;
+    if (!in.get(saved.maxSingleBolus) || !in.get(saved.maxDailyBolus)
+        || !in.get(saved.cooldownMinutes) || !in.get(saved.maxInsulinOnBoard)
+        || !in.get(saved.bgLockout) || !dailyTotal.restoreState(in)
+        || !in.get(savedHasLast) || !in.get(savedLast))
+        return false;
+
+    setLimits(saved);
+    hasLastBolus = savedHasLast != 0;
+    lastBolusTime = SimTime::fromMinutes(savedLast);
+    return true;
+}
@@ -0,0 +1,75 @@
+#ifndef BOLUSSAFETYMANAGER_H
+#define BOLUSSAFETYMANAGER_H
+
+#include <string>
+#include "RollingTotal.h"
+#include "SafetyRules.h"
+#include "SimClock.h"
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief BolusSafetyManager checks each bolus against the safety rule table
+ * (SafetyRules.h): maximum single bolus, rolling 24h limit, cooldown,
+ * IOB cap, BG lockout and reservoir. It keeps the bolus history the rules
+ * need; all timing comes from the injected SimClock, never the real clock.
+ */
+class BolusSafetyManager
+{
+public:
+    explicit BolusSafetyManager(const SimClock* clock);
+
+    /**
+     * @brief setLimits switches to another profile's limits.
+     * The rule table is only recompiled when the limits change.
+     */
+    void setLimits(const SafetyLimits& newLimits);
+    const SafetyLimits& getLimits() const { return limits; }
+
+    /**
+     * @brief makeCandidate fills in the totals and timing for a dose of
+     * amount; callers may add bg/insulinOnBoard/reservoir before checking.
+     */
+    BolusCandidate makeCandidate(double amount);
+
+    BolusBlockReason check(const BolusCandidate& candidate) const;
+
+    /**
+     * @param amount (insulin units)
+     * @param errorMessage (out param to show reason if false)
+     * @return true if safe to deliver, false otherwise
+     */
+    bool canDeliverBolus(double amount, std::string &errorMessage);
+    bool canDeliverBolus(const BolusCandidate& candidate, std::string &errorMessage) const;
+
+    /**
+     * @brief recordBolus adds to the rolling 24h total and updates lastBolusTime
+     */
+    void recordBolus(double amount);
+
+    /**
+     * @brief Insulin bolused over the last 24 simulated hours.
+     */
+    double getRollingDailyTotal();
+
+    /**
+     * @brief Checkpoint support: limits, rolling total and last bolus time.
+     */
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    static constexpr int bucketMinutes = 5;
+    static constexpr int windowMinutes = 24 * 60;
+
+    SafetyLimits limits;
+    CompiledSafetyRules rules;
+
+    const SimClock* simClock;
+    RollingTotal dailyTotal;
+    bool hasLastBolus;
+    SimTime lastBolusTime;
+};
+
+#endif // BOLUSSAFETYMANAGER_H
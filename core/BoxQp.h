@@ -0,0 +1,58 @@
+#ifndef BOXQP_H
+#define BOXQP_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+/**
+ * @brief Fixed-size box-constrained quadratic program:
+ *
+ *     minimise 0.5 x'Hx + f'x   subject to  lo <= x <= hi
+ *
+ * with H symmetric positive definite. Sized at compile time and solved
+ * in place by projected Gauss-Seidel, so a solve never allocates. Each
+ * sweep minimises exactly along one coordinate and clamps it to its box,
+ * which converges for any SPD H. Pass the previous solution in x to
+ * warm-start.
+ */
+template <int N>
+struct BoxQp {
+    using Vector = std::array<double, N>;
+    using Matrix = std::array<std::array<double, N>, N>;
+
+    Matrix H {};
+    Vector f {};
+    Vector lo {};
+    Vector hi {};
+
+    /**
+     * @brief Runs up to maxSweeps sweeps, stopping early once no
+     * coordinate moves by more than tolerance.
+     * @return the number of sweeps run
+     */
+    int solve(Vector& x, int maxSweeps, double tolerance) const
+    {
+        for (int i = 0; i < N; ++i) {
+            x[i] = std::clamp(x[i], lo[i], hi[i]);
+        }
+        for (int sweep = 1; sweep <= maxSweeps; ++sweep) {
+            double largestStep = 0.0;
+            for (int i = 0; i < N; ++i) {
+                double g = f[i];
+                for (int j = 0; j < N; ++j) {
+                    if (j != i) g += H[i][j] * x[j];
+                }
+                double xi = std::clamp(-g / H[i][i], lo[i], hi[i]);
+                largestStep = std::max(largestStep, std::fabs(xi - x[i]));
+                x[i] = xi;
+            }
+            if (largestStep <= tolerance) {
+                return sweep;
+            }
+        }
+        return maxSweeps;
+    }
+};
+
+#endif // BOXQP_H
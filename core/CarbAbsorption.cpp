@@ -0,0 +1,143 @@
+#include "CarbAbsorption.h"
+#include "BinaryIo.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int maxCurveMinutes = 320;
+
+/**
+ * @brief The cumulative absorption curves: fraction of a meal absorbed
+ * after t minutes, per speed, built once.
+ */
+struct AbsorptionCurves {
+    int duration[CarbAbsorption::speedCount];
+    double cumulative[CarbAbsorption::speedCount][maxCurveMinutes + 1];
+
+    AbsorptionCurves()
+    {
+        for (int s = 0; s < CarbAbsorption::speedCount; ++s) {
+            const double tau = CarbAbsorption::peakMinutes[s];
+            auto absorbed = [tau](double t) { return 1.0 - (1.0 + t / tau) * std::exp(-t / tau); };
+
+            // (1 + x) e^-x = 0.01 at x = 6.64
+            duration[s] = std::min(static_cast<int>(std::ceil(6.64 * tau)), maxCurveMinutes);
+            const double total = absorbed(duration[s]);
+            for (int t = 0; t <= maxCurveMinutes; ++t) {
+                cumulative[s][t] = t < duration[s] ? absorbed(t) / total : 1.0;
+            }
+        }
+    }
+};
+
+const AbsorptionCurves& curves()
+{
+    static const AbsorptionCurves instance;
+    return instance;
+}
+
+} // namespace
+
+int CarbAbsorption::durationMinutes(AbsorptionSpeed speed)
+{
+    return curves().duration[static_cast<int>(speed)];
+}
+
+void CarbAbsorption::addMeal(double grams, AbsorptionSpeed speed)
+{
+    if (!(grams > 0.0)) return;
+    carbsOnBoard += grams;
+    if (mealCount < maxMeals) {
+        meals[mealCount++] = { static_cast<float>(grams), 0, speed };
+        return;
+    }
+
+    // Pool full: fold into the youngest meal, preferring one of the same speed
+    const AbsorptionCurves& c = curves();
+    int pick = 0;
+    for (int i = 1; i < mealCount; ++i) {
+        bool sameSpeed = meals[i].speed == speed;
+        bool pickSame = meals[pick].speed == speed;
+        if (sameSpeed != pickSame ? sameSpeed : meals[i].age < meals[pick].age) pick = i;
+    }
+    Meal& m = meals[pick];
+    double remaining = m.grams * (1.0 - c.cumulative[static_cast<int>(m.speed)][m.age]);
+    m = { static_cast<float>(remaining + grams), 0, speed };
+}
+
+/**
+ * @brief advance also recomputes carbs on board from the meals' curves
+ * rather than subtracting, so rounding never accumulates.
+ */
+double CarbAbsorption::advance(int minutes)
+{
+    if (minutes <= 0 || mealCount == 0) return 0.0;
+
+    const AbsorptionCurves& c = curves();
+    double absorbed = 0.0;
+    double onBoard = 0.0;
+    for (int i = 0; i < mealCount;) {
+        Meal& m = meals[i];
+        const int s = static_cast<int>(m.speed);
+        const int to = std::min(m.age + minutes, c.duration[s]);
+        absorbed += m.grams * (c.cumulative[s][to] - c.cumulative[s][m.age]);
+        if (to >= c.duration[s]) {
+            m = meals[--mealCount];   // finished: the last meal takes its slot
+            continue;
+        }
+        m.age = static_cast<std::uint16_t>(to);
+        onBoard += m.grams * (1.0 - c.cumulative[s][to]);
+        ++i;
+    }
+    carbsOnBoard = onBoard;
+    return absorbed;
+}
+
+double CarbAbsorption::absorbedWithin(int minutes) const
+{
+    if (minutes <= 0) return 0.0;
+    const AbsorptionCurves& c = curves();
+    double sum = 0.0;
+    for (int i = 0; i < mealCount; ++i) {
+        const Meal& m = meals[i];
+        const int s = static_cast<int>(m.speed);
+        const int to = std::min(m.age + minutes, c.duration[s]);
+        sum += m.grams * (c.cumulative[s][to] - c.cumulative[s][m.age]);
+    }
+    return sum;
+}
+
+void CarbAbsorption::clear()
+{
+    mealCount = 0;
+    carbsOnBoard = 0.0;
+}
+
+void CarbAbsorption::saveState(BinaryWriter& out) const
+{
+    out.put<std::uint8_t>(static_cast<std::uint8_t>(mealCount));
+    for (int i = 0; i < mealCount; ++i) {
+        out.put(meals[i].grams);
+        out.put(meals[i].age);
+        out.put(static_cast<std::uint8_t>(meals[i].speed));
+    }
+    out.put(carbsOnBoard);
+}
+
+bool CarbAbsorption::restoreState(BinaryReader& in)
+{
+    std::uint8_t count = 0;
+    if (!in.get(count) || count > maxMeals) return false;
+    for (int i = 0; i < count; ++i) {
+        Meal m {};
+        std::uint8_t speed = 0;
+        if (!in.get(m.grams) || !in.get(m.age) || !in.get(speed) || speed >= speedCount
+            || m.age >= curves().duration[speed])
+            return false;
+        m.speed = static_cast<AbsorptionSpeed>(speed);
+        meals[i] = m;
+    }
+    mealCount = count;
+    return in.get(carbsOnBoard);
+}
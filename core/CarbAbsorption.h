@@ -0,0 +1,85 @@
+#ifndef CARBABSORPTION_H
+#define CARBABSORPTION_H
+
+#include <array>
+#include <cstdint>
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief How quickly a meal's carbs reach the blood.
+ */
+enum class AbsorptionSpeed : std::uint8_t {
+    Fast,     // juice, glucose tablets
+    Medium,   // a mixed meal
+    Slow      // high fat or protein
+};
+
+/**
+ * @brief CarbAbsorption tracks the meals still being absorbed: carbs on
+ * board and how many grams reach the blood in each interval.
+ *
+ * A meal absorbs along a gamma curve (rate t/tau^2 * e^(-t/tau), peaking
+ * tau minutes after eating), cut off once 99% is in and rescaled so the
+ * whole meal counts. The cumulative curve is tabulated per minute for
+ * each speed once, so advancing a meal is two table loads whatever the
+ * step. Active meals sit in a fixed pool of maxMeals 8-byte slots and
+ * leave it when fully absorbed, so advance() and the carbs-on-board
+ * total cost one pass over the meals still absorbing, never over past
+ * ones, and nothing is allocated. A meal eaten while the pool is full is
+ * combined with the most recent meal of the same speed (or the most
+ * recent meal) into one new meal, so no carbs are lost; the older meal's
+ * remaining carbs restart their curve, a delay of at most its age.
+ */
+class CarbAbsorption
+{
+public:
+    static constexpr int maxMeals = 16;
+    static constexpr int speedCount = 3;
+
+    /**
+     * @brief Minutes from eating to peak absorption, by speed.
+     */
+    static constexpr double peakMinutes[speedCount] = { 15.0, 25.0, 45.0 };
+
+    /**
+     * @brief Minutes until a meal of the given speed is fully absorbed.
+     */
+    static int durationMinutes(AbsorptionSpeed speed);
+
+    void addMeal(double grams, AbsorptionSpeed speed = AbsorptionSpeed::Medium);
+
+    /**
+     * @brief advance moves every meal on by minutes.
+     * @return the grams absorbed over the interval
+     */
+    double advance(int minutes);
+
+    double getCarbsOnBoard() const { return carbsOnBoard; }
+
+    /**
+     * @brief Grams expected to be absorbed over the next minutes, from
+     * the meals eaten so far.
+     */
+    double absorbedWithin(int minutes) const;
+
+    int getActiveMeals() const { return mealCount; }
+    void clear();
+
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    struct Meal {
+        float grams;
+        std::uint16_t age;    // minutes since eaten
+        AbsorptionSpeed speed;
+    };
+
+    std::array<Meal, maxMeals> meals {};
+    int mealCount = 0;
+    double carbsOnBoard = 0.0;   // g
+};
+
+#endif // CARBABSORPTION_H
@@ -0,0 +1,119 @@
+#include "CgmModel.h"
+#include "BinaryIo.h"
+#include "Trace.h"
+#include <algorithm>
+#include <sstream>
+
+CgmModel::CgmModel(SimClock* clock, unsigned seed)
+    : currentBg(7.0)  // Starting BG around 7 mmol/L
+    , reading(7.0)
+    , sensorBias(0.0)
+    , sensorBiasMinutes(0)
+    , simClock(clock)
+    , rng(seed)
+    , step(0, 19)
+{
+}
+
+double CgmModel::getCurrentBg() const
+{
+    return reading;
+}
+
+void CgmModel::setSensorBias(double offset, int minutes)
+{
+    sensorBias = offset;
+    sensorBiasMinutes = minutes > 0 ? minutes : 0;
+}
+
+const std::deque<double>& CgmModel::getLastSixReadings() const
+{
+    return lastSix;
+}
+
+/**
+ * @brief tick is one CGM sample: 5 simulated minutes pass and the BG
+ * takes a random step. The reading is that BG plus any sensor bias.
+ */
+double CgmModel::tick()
+{
+    PUMP_TRACE_SCOPE("cgm", "CgmModel::tick");
+    simClock->advance(minutesPerTick);
+
+    // Random walk in BG: +/- up to 0.2
+    double delta = (step(rng) - 10) / 50.0;
+    currentBg += delta;
+
+    // Clamp BG to a safe range
+    if (currentBg < 2.5)  currentBg = 2.5;
+    if (currentBg > 18.0) currentBg = 18.0;
+
+    reading = currentBg;
+    if (sensorBiasMinutes > 0) {
+        reading = std::min(18.0, std::max(2.5, currentBg + sensorBias));
+        sensorBiasMinutes -= minutesPerTick;
+    }
+
+    pushReading(reading);
+    estimator.update(reading, minutesPerTick);
+    return reading;
+}
+
+/**
+ * @brief pushReading inserts a new reading into the rolling queue,
+ * ensuring we only keep the last 6.
+ */
+void CgmModel::pushReading(double bg)
+{
+    lastSix.push_back(bg);
+    if (lastSix.size() > 6) {
+        lastSix.pop_front();
+    }
+}
+
+void CgmModel::copyStateFrom(const CgmModel& other)
+{
+    SimClock* clock = simClock;
+    *this = other;
+    simClock = clock;
+}
+
+void CgmModel::saveState(BinaryWriter& out) const
+{
+    out.put(currentBg);
+    out.put(reading);
+    out.put(sensorBias);
+    out.put<std::int32_t>(sensorBiasMinutes);
+    // The standard only gives the engine's state as text
+    std::ostringstream rngState;
+    rngState << rng;
+    out.putString(rngState.str());
+    out.put<std::uint8_t>(static_cast<std::uint8_t>(lastSix.size()));
+    for (double bg : lastSix) {
+        out.put(bg);
+    }
+    estimator.saveState(out);
+}
+
+bool CgmModel::restoreState(BinaryReader& in)
+{
+    std::string rngText;
+    std::uint8_t n = 0;
+    std::int32_t biasMinutes = 0;
+    if (!in.get(currentBg) || !in.get(reading) || !in.get(sensorBias) || !in.get(biasMinutes)
+        || !in.getString(rngText) || !in.get(n) || n > 6)
+        return false;
+    sensorBiasMinutes = biasMinutes;
+
+    std::istringstream rngState(rngText);
+    rngState >> rng;
+    if (!rngState) return false;
+
+    lastSix.clear();
+    for (std::uint8_t i = 0; i < n; ++i) {
+        double bg = 0.0;
+        if (!in.get(bg)) return false;
+        lastSix.push_back(bg);
+    }
+    return estimator.restoreState(in);
+}
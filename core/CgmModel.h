@@ -0,0 +1,106 @@
+#ifndef CGMMODEL_H
+#define CGMMODEL_H
+
+#include <deque>
+#include <random>
+#include "GlucoseEstimator.h"
+#include "SimClock.h"
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief CgmModel is the Qt-free glucose generator behind the CGM.
+ * Each tick() advances the shared SimClock by 5 minutes and produces
+ * a new BG reading. Every reading is fed to a GlucoseEstimator, which
+ * is what Control-IQ, alerts and the bolus calculator use for smoothed
+ * BG and trend. The last 6 raw readings are kept for display.
+ *
+ * Readings normally equal the underlying glucose; a sensor bias
+ * (setSensorBias, e.g. a compression low) offsets them for a while
+ * without changing the glucose itself.
+ */
+class CgmModel
+{
+public:
+    static constexpr int minutesPerTick = 5;
+
+    explicit CgmModel(SimClock* clock, unsigned seed = std::random_device{}());
+
+    /**
+     * @brief tick advances 5 simulated minutes and returns the new BG.
+     */
+    double tick();
+
+    /**
+     * @brief The latest sensor reading, as the pump sees it.
+     */
+    double getCurrentBg() const;
+
+    /**
+     * @brief The underlying glucose, without any sensor bias.
+     */
+    double getTrueBg() const { return currentBg; }
+    SimTime getSimTime() const { return simClock->now(); }
+
+    /**
+     * @brief Return the last 6 readings in chronological order (oldest first).
+     */
+    const std::deque<double>& getLastSixReadings() const;
+
+    /**
+     * @brief Smoothed BG, rate of change and predictions from all readings so far.
+     */
+    const GlucoseEstimator& getEstimator() const { return estimator; }
+
+    /**
+     * @brief applyEffect shifts the underlying glucose by deltaBg (mmol/L)
+     * before the next reading, for physiology the random walk lacks
+     * (see GlucoseResponse).
+     */
+    void applyEffect(double deltaBg) { currentBg += deltaBg; }
+
+    /**
+     * @brief setSensorBias offsets the next readings by offset (mmol/L)
+     * for the given minutes, replacing any bias in progress.
+     */
+    void setSensorBias(double offset, int minutes);
+
+    /**
+     * @brief reseed restarts the noise sequence, e.g. so forked
+     * simulations diverge instead of replaying the same readings.
+     */
+    void reseed(unsigned seed) { rng.seed(seed); }
+
+    /**
+     * @brief copyStateFrom makes this model continue exactly as other
+     * would, keeping its own clock. Used for in-memory forks, where the
+     * noise generator is copied directly rather than through its text
+     * form.
+     */
+    void copyStateFrom(const CgmModel& other);
+
+    /**
+     * @brief Checkpoint support: BG, noise generator, sensor bias, recent
+     * readings and estimator. The clock is saved by its owner.
+     */
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    double currentBg;
+    double reading;
+    double sensorBias;
+    int sensorBiasMinutes;
+    SimClock* simClock;
+    std::mt19937 rng;
+    std::uniform_int_distribution<int> step;
+
+    // Rolling queue for last 6 BG readings
+    std::deque<double> lastSix;
+    GlucoseEstimator estimator;
+
+    void pushReading(double bg);
+};
+
+#endif // CGMMODEL_H
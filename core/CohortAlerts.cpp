@@ -0,0 +1,138 @@
+#include "CohortAlerts.h"
+#include <algorithm>
+#include <cstring>
+
+const CohortAlerts::Rule CohortAlerts::rules[CohortAlerts::channelCount] = {
+    { 3.9, 4.4 },     // BgLow
+    { 13.9, 12.0 },   // BgHigh
+    { 20.0, 25.0 },   // ReservoirLow
+    { 5.0, 10.0 },    // ReservoirCritical
+    { 20.0, 25.0 },   // BatteryLow
+    { 5.0, 10.0 },    // BatteryCritical
+};
+
+CohortAlerts::CohortAlerts(std::size_t patients)
+{
+    resize(patients);
+}
+
+void CohortAlerts::resize(std::size_t patients)
+{
+    active.resize(patients, 0);
+    changed.assign((patients + 7) / 8 * 8, 0);
+    reported.resize(patients, 0);
+    pending.resize((patients + 7) / 8 * 8, 0);
+    std::fill(pending.begin() + static_cast<std::ptrdiff_t>(patients), pending.end(), 0);
+    muted.resize(patients, 0);
+    snoozedUntil.resize(patients * channelCount, SimTime::earliest());
+}
+
+void CohortAlerts::setMuted(std::size_t patient, AlertChannel channel, bool mute)
+{
+    std::uint8_t bit = static_cast<std::uint8_t>(1u << static_cast<int>(channel));
+    if (mute) {
+        muted[patient] |= bit;
+    } else {
+        muted[patient] &= static_cast<std::uint8_t>(~bit);
+    }
+}
+
+/**
+ * @brief evaluate: the first loop is straight-line compares and bit
+ * operations over contiguous columns, so it auto-vectorises; the second
+ * touches eight patients per load (changed and pending bytes) and calls
+ * report() only for patients with a change or a held-back raise.
+ */
+void CohortAlerts::evaluate(const AlertLevels& levels, SimTime now, std::vector<AlertTransition>& out)
+{
+    const std::size_t n = active.size();
+    if (levels.count != n) return;
+
+    const double* bg = levels.bg;
+    const double* reservoir = levels.reservoir;
+    const double* battery = levels.battery;
+    std::uint8_t* act = active.data();
+    std::uint8_t* chg = changed.data();
+
+    const double bgLowOn = rules[0].trigger, bgLowOff = rules[0].clear;
+    const double bgHighOn = rules[1].trigger, bgHighOff = rules[1].clear;
+    const double resLowOn = rules[2].trigger, resLowOff = rules[2].clear;
+    const double resCritOn = rules[3].trigger, resCritOff = rules[3].clear;
+    const double batLowOn = rules[4].trigger, batLowOff = rules[4].clear;
+    const double batCritOn = rules[5].trigger, batCritOff = rules[5].clear;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const double g = bg[i], r = reservoir[i], b = battery[i];
+        // NaN compares false both ways, so a missing level changes nothing
+        unsigned on = unsigned(g < bgLowOn) | unsigned(g > bgHighOn) << 1
+                    | unsigned(r <= resLowOn) << 2 | unsigned(r <= resCritOn) << 3
+                    | unsigned(b <= batLowOn) << 4 | unsigned(b <= batCritOn) << 5;
+        unsigned off = unsigned(g > bgLowOff) | unsigned(g < bgHighOff) << 1
+                     | unsigned(r > resLowOff) << 2 | unsigned(r > resCritOff) << 3
+                     | unsigned(b > batLowOff) << 4 | unsigned(b > batCritOff) << 5;
+        std::uint8_t before = act[i];
+        std::uint8_t after = static_cast<std::uint8_t>((before & ~off) | on);
+        act[i] = after;
+        chg[i] = static_cast<std::uint8_t>(before ^ after);
+    }
+
+    const std::uint8_t* pend = pending.data();
+    for (std::size_t i = 0; i < n; i += 8) {
+        std::uint64_t word, held;
+        std::memcpy(&word, chg + i, sizeof(word));
+        std::memcpy(&held, pend + i, sizeof(held));
+        if ((word | held) == 0) continue;
+        for (std::size_t j = i; j < i + 8 && j < n; ++j) {
+            if (chg[j] | pend[j]) report(j, levels, now, out);
+        }
+    }
+}
+
+/**
+ * @brief report handles one patient's changed and pending channels. A
+ * raise held back by mute or snooze stays pending while the channel is
+ * on and is reported once neither applies; a channel turning off drops
+ * its pending raise, and is reported as a clear only if it was raised.
+ */
+void CohortAlerts::report(std::size_t patient, const AlertLevels& levels, SimTime now,
+                          std::vector<AlertTransition>& out)
+{
+    for (int c = 0; c < channelCount; ++c) {
+        std::uint8_t bit = static_cast<std::uint8_t>(1u << c);
+        if (!((changed[patient] | pending[patient]) & bit)) continue;
+
+        AlertChannel channel = static_cast<AlertChannel>(c);
+        double value = c < 2 ? levels.bg[patient] : c < 4 ? levels.reservoir[patient] : levels.battery[patient];
+        if (active[patient] & bit) {
+            SimTime& until = snoozedUntil[patient * channelCount + c];
+            if ((muted[patient] & bit) || now < until) {
+                pending[patient] |= bit;
+                continue;
+            }
+            pending[patient] &= static_cast<std::uint8_t>(~bit);
+            until = now + snoozeMinutes;
+            reported[patient] |= bit;
+            out.push_back({ static_cast<std::uint32_t>(patient), channel, true, value });
+        } else {
+            pending[patient] &= static_cast<std::uint8_t>(~bit);
+            if (reported[patient] & bit) {
+                reported[patient] &= static_cast<std::uint8_t>(~bit);
+                out.push_back({ static_cast<std::uint32_t>(patient), channel, false, value });
+            }
+        }
+    }
+}
+
+const char* CohortAlerts::channelName(AlertChannel channel)
+{
+    switch (channel) {
+    case AlertChannel::BgLow:             return "BG low";
+    case AlertChannel::BgHigh:            return "BG high";
+    case AlertChannel::ReservoirLow:      return "Insulin low";
+    case AlertChannel::ReservoirCritical: return "Insulin critically low";
+    case AlertChannel::BatteryLow:        return "Battery low";
+    case AlertChannel::BatteryCritical:   return "Battery critically low";
+    case AlertChannel::Count:             break;
+    }
+    return "?";
+}
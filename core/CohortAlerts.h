@@ -0,0 +1,118 @@
+#ifndef COHORTALERTS_H
+#define COHORTALERTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SimTime.h"
+
+/**
+ * @brief The conditions CohortAlerts watches, one bit each in its masks.
+ */
+enum class AlertChannel : std::uint8_t {
+    BgLow,
+    BgHigh,
+    ReservoirLow,
+    ReservoirCritical,
+    BatteryLow,
+    BatteryCritical,
+    Count
+};
+
+/**
+ * @brief Structure-of-arrays input for one evaluation: row i is patient i.
+ * A NaN leaves that patient's channels on it as they are.
+ */
+struct AlertLevels {
+    const double* bg = nullptr;          // mmol/L
+    const double* reservoir = nullptr;   // U
+    const double* battery = nullptr;     // %
+    std::size_t count = 0;
+};
+
+/**
+ * @brief A channel turning on (raised) or off for one patient.
+ */
+struct AlertTransition {
+    std::uint32_t patient;
+    AlertChannel channel;
+    bool raised;
+    double value;   // the level that caused it
+};
+
+/**
+ * @brief CohortAlerts evaluates the BG, reservoir and battery thresholds
+ * of a whole cohort per tick and reports only what changed.
+ *
+ * Each channel has hysteresis: it turns on past its trigger level and
+ * only turns off once the level is back past a separate clear level, so
+ * a reading hovering at a threshold does not flap. evaluate() is two
+ * passes: a branch-free pass over the level columns that updates every
+ * patient's active bitmask and marks changed patients in a byte column,
+ * then a scan of that column eight patients at a time that only stops at
+ * patients with a change. Per-patient suppression (muted channels, and a
+ * snooze that holds back a repeat of the same alert for snoozeMinutes
+ * after it was raised) is applied there, so it costs nothing for the
+ * patients with no change. A suppressed raise is not dropped: it stays
+ * pending while the channel is on, the scan also stops at patients with
+ * one, and it is reported when the snooze ends or the channel is
+ * unmuted. A clear is reported only for a raise that was.
+ */
+class CohortAlerts
+{
+public:
+    static constexpr int channelCount = static_cast<int>(AlertChannel::Count);
+    static constexpr int defaultSnoozeMinutes = 30;
+
+    struct Rule {
+        double trigger;   // on at or past it (BG: strictly past)
+        double clear;     // off once the level is past it the other way
+    };
+
+    /**
+     * @brief The levels, by channel. BgLow turns on below its trigger
+     * and BgHigh above it, as in WarningMonitor; the others turn on at or
+     * below theirs, as in PumpDevice.
+     */
+    static const Rule rules[channelCount];
+
+    explicit CohortAlerts(std::size_t patients = 0);
+
+    /**
+     * @brief resize keeps the state of the first patients; new ones
+     * start with no alerts.
+     */
+    void resize(std::size_t patients);
+    std::size_t size() const { return active.size(); }
+
+    void setSnoozeMinutes(int minutes) { snoozeMinutes = minutes; }
+    void setMuted(std::size_t patient, AlertChannel channel, bool muted);
+
+    /**
+     * @brief evaluate checks levels (all three columns, with count equal
+     * to size()) at the simulated time now and appends the transitions
+     * to out, by patient and then channel.
+     */
+    void evaluate(const AlertLevels& levels, SimTime now, std::vector<AlertTransition>& out);
+
+    bool isActive(std::size_t patient, AlertChannel channel) const
+    {
+        return (active[patient] >> static_cast<int>(channel)) & 1u;
+    }
+
+    static const char* channelName(AlertChannel channel);
+
+private:
+    int snoozeMinutes = defaultSnoozeMinutes;
+    std::vector<std::uint8_t> active;     // channel bits on now
+    std::vector<std::uint8_t> changed;    // bits that changed in the last pass, padded to 8
+    std::vector<std::uint8_t> reported;   // active bits whose raise was reported
+    std::vector<std::uint8_t> pending;    // active bits whose raise was suppressed, padded to 8
+    std::vector<std::uint8_t> muted;
+    std::vector<SimTime> snoozedUntil;    // patient * channelCount + channel
+
+    void report(std::size_t patient, const AlertLevels& levels, SimTime now,
+                std::vector<AlertTransition>& out);
+};
+
+#endif // COHORTALERTS_H
@@ -0,0 +1,30 @@
+#include "ControlIQ.h"
+
+ControllerPolicy makeController(ControllerKind kind)
+{
+    switch (kind) {
+    case ControllerKind::Pid: return PidPolicy();
+    case ControllerKind::Mpc: return MpcPolicy();
+    default:                  return ThresholdPolicy();
+    }
+}
+
+const char* controllerName(ControllerKind kind)
+{
+    switch (kind) {
+    case ControllerKind::Pid: return "pid";
+    case ControllerKind::Mpc: return "mpc";
+    default:                  return "threshold";
+    }
+}
+
+bool parseControllerKind(const std::string& name, ControllerKind& kind)
+{
+    for (ControllerKind k : { ControllerKind::Threshold, ControllerKind::Pid, ControllerKind::Mpc }) {
+        if (name == controllerName(k)) {
+            kind = k;
+            return true;
+        }
+    }
+    return false;
+}
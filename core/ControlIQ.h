@@ -0,0 +1,50 @@
+#ifndef CONTROLIQ_H
+#define CONTROLIQ_H
+
+#include <cstddef>
+#include <string>
+#include <variant>
+#include "ControllerPolicy.h"
+#include "MpcPolicy.h"
+#include "PidPolicy.h"
+#include "ThresholdPolicy.h"
+
+/**
+ * @brief Which Control-IQ policy a run uses.
+ */
+enum class ControllerKind {
+    Threshold,
+    Pid,
+    Mpc
+};
+
+/**
+ * @brief A run's controller, chosen at runtime. std::visit dispatches
+ * once per decision to a statically known decide(), with no vtable.
+ */
+using ControllerPolicy = std::variant<ThresholdPolicy, PidPolicy, MpcPolicy>;
+
+ControllerPolicy makeController(ControllerKind kind);
+const char* controllerName(ControllerKind kind);
+bool parseControllerKind(const std::string& name, ControllerKind& kind);
+
+inline ControllerDecision decide(ControllerPolicy& policy, const ControllerInput& in)
+{
+    return std::visit([&in](auto& p) { return p.decide(in); }, policy);
+}
+
+/**
+ * @brief decideBatch runs one policy type over a cohort: policies[i]
+ * decides for inputs[i]. Instantiated per policy, so the inner call is
+ * direct (and inlinable) rather than dispatched per patient.
+ */
+template <class Policy>
+void decideBatch(Policy* policies, const ControllerInput* inputs,
+                 std::size_t n, ControllerDecision* out)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = policies[i].decide(inputs[i]);
+    }
+}
+
+#endif // CONTROLIQ_H
@@ -0,0 +1,50 @@
+#ifndef CONTROLLERPOLICY_H
+#define CONTROLLERPOLICY_H
+
+#include <cstdint>
+#include <limits>
+#include "UserProfile.h"
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief What Control-IQ does for the next CGM interval.
+ */
+enum class ControlAction : std::uint8_t {
+    None,          // run the scheduled basal
+    SuspendBasal,  // deliver nothing
+    AdjustBasal,   // deliver basalRate instead of the scheduled rate
+    AutoBolus      // deliver bolusUnits now (scheduled basal continues)
+};
+
+/**
+ * @brief Everything a controller policy sees at one CGM reading.
+ */
+struct ControllerInput {
+    double bg = 0.0;              // mmol/L, smoothed current glucose
+    double trend = 0.0;           // mmol/L per minute
+    bool hasTrend = false;        // false until the estimator has warmed up
+    double insulinOnBoard = 0.0;  // U, net of scheduled basal
+    double carbsOnBoard = 0.0;    // g still to be absorbed
+    double dtMinutes = 5.0;       // time since the previous decision
+    TherapySettings settings {};  // settings in force now
+};
+
+struct ControllerDecision {
+    ControlAction action = ControlAction::None;
+    double basalRate = 0.0;       // U/h, for AdjustBasal
+    double bolusUnits = 0.0;      // U, for AutoBolus
+    double predictedBg = std::numeric_limits<double>::quiet_NaN();  // mmol/L, 30 min ahead
+};
+
+/*
+ * A controller policy is any class with
+ *     ControllerDecision decide(const ControllerInput& in);
+ *     void saveState(BinaryWriter& out) const;   // for checkpoints
+ *     bool restoreState(BinaryReader& in);
+ * Policies are used through templates or std::variant (see ControlIQ.h),
+ * never through a base class, so the call is resolved at compile time.
+ */
+
+#endif // CONTROLLERPOLICY_H
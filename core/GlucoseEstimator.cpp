@@ -0,0 +1,80 @@
+#include "GlucoseEstimator.h"
+#include "BinaryIo.h"
+
+namespace {
+
+// Prior spread of the rate before any trend has been seen (mmol/L/min)^2
+const double initialRateVariance = 0.01;
+
+} // namespace
+
+GlucoseEstimator::GlucoseEstimator(double measurementVariance, double accelerationVariance)
+    : measurementVariance(measurementVariance)
+    , accelerationVariance(accelerationVariance)
+{
+    reset();
+}
+
+void GlucoseEstimator::reset()
+{
+    glucose = 0.0;
+    rate = 0.0;
+    pGG = pGR = pRR = 0.0;
+    readings = 0;
+}
+
+void GlucoseEstimator::update(double reading, double dtMinutes)
+{
+    if (readings == 0) {
+        glucose = reading;
+        rate = 0.0;
+        pGG = measurementVariance;
+        pGR = 0.0;
+        pRR = initialRateVariance;
+        readings = 1;
+        return;
+    }
+
+    // Predict: x = F x, P = F P F' + Q with F = [1 dt; 0 1]
+    const double dt = dtMinutes;
+    const double q = accelerationVariance;
+    glucose += rate * dt;
+    pGG += dt * (2.0 * pGR + dt * pRR) + q * dt * dt * dt / 3.0;
+    pGR += dt * pRR + q * dt * dt / 2.0;
+    pRR += q * dt;
+
+    // Update with H = [1 0]
+    const double innovation = reading - glucose;
+    const double s = pGG + measurementVariance;
+    const double kG = pGG / s;
+    const double kR = pGR / s;
+    glucose += kG * innovation;
+    rate += kR * innovation;
+    pRR -= kR * pGR;
+    pGR -= kR * pGG;   // uses the prior pGG, so update it last
+    pGG -= kG * pGG;
+
+    ++readings;
+}
+
+void GlucoseEstimator::saveState(BinaryWriter& out) const
+{
+    out.put(glucose);
+    out.put(rate);
+    out.put(pGG);
+    out.put(pGR);
+    out.put(pRR);
+    out.put<std::int32_t>(readings);
+}
+
+bool GlucoseEstimator::restoreState(BinaryReader& in)
+{
+    std::int32_t n = 0;
+    if (!in.get(glucose) || !in.get(rate) || !in.get(pGG) || !in.get(pGR)
+        || !in.get(pRR) || !in.get(n) || n < 0) {
+        reset();
+        return false;
+    }
+    readings = n;
+    return true;
+}
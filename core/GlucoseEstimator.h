@@ -0,0 +1,63 @@
+#ifndef GLUCOSEESTIMATOR_H
+#define GLUCOSEESTIMATOR_H
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief GlucoseEstimator is a two-state Kalman filter over CGM readings:
+ * glucose (mmol/L) and its rate of change (mmol/L per minute), with a
+ * constant-rate model driven by random acceleration. Each reading is an
+ * O(1) predict + update on a 2x2 covariance, so smoothed BG, trend and
+ * predictions never rescan a window of readings.
+ */
+class GlucoseEstimator
+{
+public:
+    static constexpr int warmupReadings = 3;
+
+    /**
+     * @param measurementVariance sensor noise, (mmol/L)^2
+     * @param accelerationVariance process noise, (mmol/L/min^2)^2
+     */
+    explicit GlucoseEstimator(double measurementVariance = 0.04,
+                              double accelerationVariance = 1e-5);
+
+    /**
+     * @brief update folds in a reading taken dtMinutes after the previous one.
+     */
+    void update(double reading, double dtMinutes);
+    void reset();
+
+    double smoothedBg() const { return glucose; }
+    double rateOfChange() const { return rate; }   // mmol/L per minute
+
+    /**
+     * @brief Glucose expected minutesAhead from now along the current trend.
+     */
+    double predict(double minutesAhead) const { return glucose + rate * minutesAhead; }
+
+    /**
+     * @brief True once enough readings have arrived for the trend to mean something.
+     */
+    bool hasTrend() const { return readings >= warmupReadings; }
+    int getReadingCount() const { return readings; }
+
+    /**
+     * @brief Checkpoint support: state and covariance (the noise model
+     * comes from the constructor).
+     */
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    double measurementVariance;
+    double accelerationVariance;
+
+    double glucose;
+    double rate;
+    double pGG, pGR, pRR;  // symmetric covariance
+    int readings;
+};
+
+#endif // GLUCOSEESTIMATOR_H
@@ -0,0 +1,47 @@
+#include "GlucoseResponse.h"
+#include "BinaryIo.h"
+#include "InsulinOnBoard.h"
+#include <algorithm>
+#include <cmath>
+
+void GlucoseResponse::startExercise(int minutes, double intensity)
+{
+    exerciseMinutesLeft = std::max(0, minutes);
+    exerciseIntensity = std::max(0.0, intensity);
+}
+
+double GlucoseResponse::advance(int minutes, double insulinOnBoard, double carbsAbsorbed,
+                                const TherapySettings& settings)
+{
+    const double dt = minutes;
+    double sensitivity = 1.0;
+    double effect = 0.0;
+    if (exerciseMinutesLeft > 0) {
+        double active = std::min(dt, static_cast<double>(exerciseMinutesLeft));
+        sensitivity += exerciseIntensity;
+        effect -= exerciseDropPerHour * exerciseIntensity * active / 60.0;
+        exerciseMinutesLeft -= static_cast<int>(active);
+    }
+
+    double acting = insulinOnBoard * (1.0 - std::exp(-dt / InsulinOnBoard::defaultTauMinutes));
+    effect -= settings.correctionFactor * acting * sensitivity;
+
+    if (settings.carbRatio > 0.0) {
+        effect += settings.correctionFactor / settings.carbRatio * carbsAbsorbed;
+    }
+    return effect;
+}
+
+void GlucoseResponse::saveState(BinaryWriter& out) const
+{
+    out.put<std::int32_t>(exerciseMinutesLeft);
+    out.put(exerciseIntensity);
+}
+
+bool GlucoseResponse::restoreState(BinaryReader& in)
+{
+    std::int32_t left = 0;
+    if (!in.get(left) || !in.get(exerciseIntensity)) return false;
+    exerciseMinutesLeft = left;
+    return true;
+}
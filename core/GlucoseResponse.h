@@ -0,0 +1,53 @@
+#ifndef GLUCOSERESPONSE_H
+#define GLUCOSERESPONSE_H
+
+#include "UserProfile.h"
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief GlucoseResponse is the physiology CgmModel's random walk lacks:
+ * how insulin, meals and exercise move BG. advance() returns the BG
+ * change over one interval, which the simulation applies to the CGM
+ * model before its next reading.
+ *
+ * - Insulin on board acts with the same first-order time constant as
+ *   InsulinOnBoard, lowering BG by the correction factor per unit acted.
+ * - Carbs absorbed over the interval (from CarbAbsorption, which peaks a
+ *   little before insulin acts) raise BG by correctionFactor / carbRatio
+ *   per gram; a matched meal bolus gives a small rise, then returns to
+ *   the starting BG.
+ * - Exercise lowers BG by exerciseDropPerHour x intensity and makes
+ *   acting insulin (1 + intensity) times as strong while it lasts.
+ */
+class GlucoseResponse
+{
+public:
+    static constexpr double exerciseDropPerHour = 2.0;   // mmol/L at intensity 1
+
+    /**
+     * @brief startExercise replaces any exercise in progress.
+     * @param intensity 0.5 light, 1 moderate, 1.5 hard
+     */
+    void startExercise(int minutes, double intensity);
+
+    bool isExercising() const { return exerciseMinutesLeft > 0; }
+
+    /**
+     * @brief advance moves exercise on by minutes.
+     * @param carbsAbsorbed grams absorbed over the interval
+     * @return the BG change (mmol/L) over the interval
+     */
+    double advance(int minutes, double insulinOnBoard, double carbsAbsorbed,
+                   const TherapySettings& settings);
+
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    int exerciseMinutesLeft = 0;
+    double exerciseIntensity = 0.0;
+};
+
+#endif // GLUCOSERESPONSE_H
@@ -0,0 +1,87 @@
+#include "HistoryManager.h"
+#include "BinaryIo.h"
+#include "Trace.h"
+#include <atomic>
+
+void HistoryManager::addRecord(const HistoryRecord& record)
+{
+    PUMP_TRACE_SCOPE("history", "HistoryManager::addRecord");
+    Page& page = writablePage();
+    page.push_back(record);
+    ++count;
+
+    // Notes short enough for the small-string buffer live in the record
+    static const std::size_t inlineCapacity = std::string().capacity();
+    const std::string& notes = page.back().getNotes();
+    if (notes.capacity() > inlineCapacity) stringBytes += notes.capacity() + 1;
+}
+
+/**
+ * @brief writablePage returns the page the next record goes into: a new
+ * page when the last one is full, or a private copy of the last page
+ * when a fork still shares it.
+ */
+HistoryManager::Page& HistoryManager::writablePage()
+{
+    if (pages.empty() || pages.back()->size() == pageRecords) {
+        pages.push_back(std::make_shared<Page>());
+        pages.back()->reserve(pageRecords);
+    } else if (pages.back().use_count() > 1) {
+        auto copy = std::make_shared<Page>();
+        copy->reserve(pageRecords);
+        copy->assign(pages.back()->begin(), pages.back()->end());
+        pages.back() = std::move(copy);
+    } else {
+        // Sole owner, but a fork on another thread may just have copied
+        // this page and dropped it: order its reads before our write
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *pages.back();
+}
+
+void HistoryManager::clear()
+{
+    pages.clear();
+    count = 0;
+    stringBytes = 0;
+}
+
+std::size_t HistoryManager::getMemoryBytes() const
+{
+    return pages.size() * pageRecords * sizeof(HistoryRecord) + stringBytes;
+}
+
+void HistoryManager::saveState(BinaryWriter& out) const
+{
+    out.put<std::uint64_t>(count);
+    for (const HistoryRecord& rec : getRecords()) {
+        out.put<std::int64_t>(rec.getTime().minutes());
+        out.put<std::uint8_t>(static_cast<std::uint8_t>(rec.getRecordType()));
+        out.put(rec.getInsulinAmount());
+        out.putString(rec.getNotes());
+        out.put(rec.getProfileVersion());
+    }
+}
+
+bool HistoryManager::restoreState(BinaryReader& in)
+{
+    clear();
+    std::uint64_t n = 0;
+    if (!in.get(n)) return false;
+
+    std::string notes;
+    for (std::uint64_t i = 0; i < n; ++i) {
+        std::int64_t minute = 0;
+        std::uint8_t type = 0;
+        double amount = 0.0;
+        std::uint64_t version = 0;
+        if (!in.get(minute) || !in.get(type) || !in.get(amount)
+            || !in.getString(notes) || !in.get(version)
+            || type > static_cast<std::uint8_t>(RecordType::Other)) {
+            clear();
+            return false;
+        }
+        addRecord({ SimTime::fromMinutes(minute), static_cast<RecordType>(type), amount, notes, version });
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+#ifndef HISTORYMANAGER_H
+#define HISTORYMANAGER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "HistoryRecord.h"
+
+class BinaryWriter;
+class BinaryReader;
+class HistoryManager;
+
+/**
+ * @brief HistoryView is a read-only, indexable view of a HistoryManager's
+ * records in the order they were added. It stays valid while the manager
+ * lives; records added later show up in it.
+ */
+class HistoryView
+{
+public:
+    class const_iterator
+    {
+    public:
+        const_iterator(const HistoryView* view, std::size_t index) : view(view), index(index) {}
+
+        const HistoryRecord& operator*() const { return (*view)[index]; }
+        const HistoryRecord* operator->() const { return &(*view)[index]; }
+        const_iterator& operator++() { ++index; return *this; }
+        bool operator==(const const_iterator& o) const { return index == o.index; }
+        bool operator!=(const const_iterator& o) const { return index != o.index; }
+
+    private:
+        const HistoryView* view;
+        std::size_t index;
+    };
+
+    explicit HistoryView(const HistoryManager* manager) : manager(manager) {}
+
+    std::size_t size() const;
+    bool empty() const { return size() == 0; }
+    const HistoryRecord& operator[](std::size_t i) const;
+    const HistoryRecord& back() const { return (*this)[size() - 1]; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+    const HistoryManager* manager;
+};
+
+/**
+ * @brief HistoryManager is responsible for storing all HistoryRecords
+ * in a single list: CGM readings, bolus events, warnings, etc.
+ *
+ * Records live in fixed-size pages held by shared pointer. Copying a
+ * HistoryManager copies only the page table, so a forked simulation
+ * shares its parent's past; the first add to a shared page copies that
+ * page alone (copy-on-write), and full pages are never written again.
+ * A page is not moved once created, so record addresses are stable.
+ * Histories sharing pages may be written from different threads.
+ */
+class HistoryManager
+{
+public:
+    static constexpr std::size_t pageShift = 8;
+    static constexpr std::size_t pageRecords = std::size_t(1) << pageShift;  // 256
+
+    void addRecord(const HistoryRecord& record);
+    HistoryView getRecords() const { return HistoryView(this); }
+
+    std::size_t size() const { return count; }
+    const HistoryRecord& at(std::size_t i) const
+    {
+        return (*pages[i >> pageShift])[i & (pageRecords - 1)];
+    }
+
+    void clear();
+
+    /**
+     * @brief Approximate heap held by the log (record slots plus string
+     * buffers), kept up to date on each add. Shared pages are counted in
+     * every history that holds them.
+     */
+    std::size_t getMemoryBytes() const;
+
+    /**
+     * @brief Checkpoint support: every record, in order.
+     */
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    using Page = std::vector<HistoryRecord>;
+
+    std::vector<std::shared_ptr<Page>> pages;
+    std::size_t count = 0;
+    std::size_t stringBytes = 0;
+
+    Page& writablePage();
+};
+
+inline std::size_t HistoryView::size() const { return manager->size(); }
+inline const HistoryRecord& HistoryView::operator[](std::size_t i) const { return manager->at(i); }
+
+#endif // HISTORYMANAGER_H
@@ -0,0 +1,12 @@
+#include "HistoryRecord.h"
+
+const char* recordTypeName(RecordType type)
+{
+    switch (type) {
+    case RecordType::ManualBolus: return "Manual Bolus";
+    case RecordType::AutoBolus:   return "Auto Bolus";
+    case RecordType::CgmReading:  return "CGM Reading";
+    case RecordType::Warning:     return "Warning";
+    default:                      return "Other";
+    }
+}
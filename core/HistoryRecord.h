@@ -0,0 +1,60 @@
+#ifndef HISTORYRECORD_H
+#define HISTORYRECORD_H
+
+#include <cstdint>
+#include <string>
+#include "SimTime.h"
+
+/**
+ * @brief RecordType categorizes events in the pump's history log
+ * (manual bolus, auto bolus, CGM reading, warning, etc.).
+ */
+enum class RecordType {
+    ManualBolus,
+    AutoBolus,
+    CgmReading,
+    Warning,
+    Other
+};
+
+/**
+ * @brief HistoryRecord stores an event (simulated time, record type,
+ * insulin amount if relevant, notes, and the version of the active
+ * profile it was made under; 0 when no profile was involved). The time
+ * is kept as a SimTime and only formatted when shown.
+ */
+class HistoryRecord
+{
+public:
+    HistoryRecord(SimTime time,
+                  RecordType type,
+                  double amount,
+                  const std::string& notes,
+                  std::uint64_t profileVer = 0)
+        : time(time),
+          recordType(type),
+          insulinAmount(amount),
+          recordNotes(notes),
+          profileVersion(profileVer)
+    {}
+
+    SimTime getTime() const { return time; }
+    RecordType getRecordType() const { return recordType; }
+    double getInsulinAmount() const { return insulinAmount; }
+    const std::string& getNotes() const { return recordNotes; }
+    std::uint64_t getProfileVersion() const { return profileVersion; }
+
+private:
+    SimTime time;
+    RecordType recordType;
+    double insulinAmount;
+    std::string recordNotes;
+    std::uint64_t profileVersion;
+};
+
+/**
+ * @brief Display name of a record type, as shown in the history views.
+ */
+const char* recordTypeName(RecordType type);
+
+#endif
@@ -0,0 +1,13 @@
+#include "InsulinOnBoard.h"
+#include <cmath>
+
+InsulinOnBoard::InsulinOnBoard(double tauMinutes)
+    : tauMinutes(tauMinutes)
+    , onBoard(0.0)
+{
+}
+
+void InsulinOnBoard::advance(double minutes)
+{
+    onBoard *= std::exp(-minutes / tauMinutes);
+}
@@ -0,0 +1,26 @@
+#ifndef INSULINONBOARD_H
+#define INSULINONBOARD_H
+
+/**
+ * @brief InsulinOnBoard tracks net insulin still acting: boluses plus basal
+ * delivered above (or below, negative) the schedule, decaying
+ * exponentially with the given time constant. O(1) per update.
+ */
+class InsulinOnBoard
+{
+public:
+    static constexpr double defaultTauMinutes = 55.0;
+
+    explicit InsulinOnBoard(double tauMinutes = defaultTauMinutes);
+
+    void add(double units) { onBoard += units; }
+    void advance(double minutes);
+    double value() const { return onBoard; }
+    void setValue(double units) { onBoard = units; }
+
+private:
+    double tauMinutes;
+    double onBoard;
+};
+
+#endif // INSULINONBOARD_H
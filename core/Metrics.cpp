@@ -0,0 +1,207 @@
+#include "Metrics.h"
+#include <cstdio>
+
+namespace {
+
+int highestBit(std::uint64_t v)
+{
+    int bit = 0;
+    while (v >>= 1) ++bit;
+    return bit;
+}
+
+void appendSample(std::string& out, const std::string& name, const std::string& labels, double value)
+{
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.9g", value);
+    out += name;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+    out += buf;
+    out += '\n';
+}
+
+std::string joinLabels(const std::string& labels, const std::string& extra)
+{
+    return labels.empty() ? extra : labels + "," + extra;
+}
+
+} // namespace
+
+int LatencyHistogram::bucketIndex(std::uint64_t ns)
+{
+    if (ns < static_cast<std::uint64_t>(subBucketCount)) {
+        return static_cast<int>(ns);
+    }
+    int shift = highestBit(ns) - subBucketBits;
+    int sub = static_cast<int>((ns >> shift) & (subBucketCount - 1));
+    return (shift + 1) * subBucketCount + sub;
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < subBucketCount) {
+        return static_cast<std::uint64_t>(index);
+    }
+    int shift = index / subBucketCount - 1;
+    std::uint64_t sub = static_cast<std::uint64_t>(index % subBucketCount) + subBucketCount;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::uint64_t ns)
+{
+    buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sumNs.fetch_add(ns, std::memory_order_relaxed);
+
+    std::uint64_t seen = maxNs.load(std::memory_order_relaxed);
+    while (ns > seen && !maxNs.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+}
+
+std::uint64_t LatencyHistogram::quantile(double q) const
+{
+    std::uint64_t n = count();
+    if (n == 0) return 0;
+
+    std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(n - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (int i = 0; i < bucketCount; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            std::uint64_t bound = bucketUpperBound(i);
+            std::uint64_t top = max();
+            return bound < top ? bound : top;
+        }
+    }
+    return max();
+}
+
+std::uint64_t LatencyHistogram::countAbove(std::uint64_t thresholdNs) const
+{
+    std::uint64_t above = 0;
+    for (int i = bucketIndex(thresholdNs) + 1; i < bucketCount; ++i) {
+        above += buckets[i].load(std::memory_order_relaxed);
+    }
+    return above;
+}
+
+MetricsRegistry::Entry& MetricsRegistry::add(Kind kind, const std::string& name,
+                                             const std::string& help, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.emplace_back();
+    Entry& e = entries.back();
+    e.kind = kind;
+    e.name = name;
+    e.help = help;
+    e.labels = labels;
+    return e;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels)
+{
+    return add(Kind::Counter, name, help, labels).counterValue;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels)
+{
+    return add(Kind::Gauge, name, help, labels).gaugeValue;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const std::string& labels)
+{
+    Entry& e = add(Kind::Histogram, name, help, labels);
+    e.histogramValue.reset(new LatencyHistogram());
+    return *e.histogramValue;
+}
+
+/**
+ * @brief renderText writes each family's HELP/TYPE once, before its
+ * first sample; families keep registration order.
+ */
+std::string MetricsRegistry::renderText() const
+{
+    static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string out;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const Entry& e = entries[i];
+
+        bool firstOfFamily = true;
+        for (std::size_t j = 0; j < i && firstOfFamily; ++j) {
+            firstOfFamily = entries[j].name != e.name;
+        }
+        if (!firstOfFamily) continue;
+
+        const char* type = e.kind == Kind::Counter ? "counter"
+                         : e.kind == Kind::Gauge   ? "gauge"
+                                                   : "summary";
+        out += "# HELP " + e.name + " " + e.help + "\n";
+        out += "# TYPE " + e.name + " " + type + "\n";
+
+        for (std::size_t j = i; j < entries.size(); ++j) {
+            const Entry& m = entries[j];
+            if (m.name != e.name) continue;
+
+            switch (m.kind) {
+            case Kind::Counter:
+                appendSample(out, m.name, m.labels, static_cast<double>(m.counterValue.get()));
+                break;
+            case Kind::Gauge:
+                appendSample(out, m.name, m.labels, m.gaugeValue.get());
+                break;
+            case Kind::Histogram:
+                for (double q : quantiles) {
+                    char label[32];
+                    std::snprintf(label, sizeof(label), "quantile=\"%g\"", q);
+                    appendSample(out, m.name, joinLabels(m.labels, label),
+                                 m.histogramValue->quantile(q) * 1e-9);
+                }
+                appendSample(out, m.name + "_sum", m.labels, m.histogramValue->sum() * 1e-9);
+                appendSample(out, m.name + "_count", m.labels, static_cast<double>(m.histogramValue->count()));
+                break;
+            }
+        }
+
+        if (e.kind == Kind::Histogram) {
+            out += "# TYPE " + e.name + "_max gauge\n";
+            for (const Entry& m : entries) {
+                if (m.name == e.name) {
+                    appendSample(out, m.name + "_max", m.labels, m.histogramValue->max() * 1e-9);
+                }
+            }
+        }
+    }
+    return out;
+}
+
+bool MetricsRegistry::writeText(const std::string& path, std::string& error) const
+{
+    const std::string text = renderText();
+    const std::string tmp = path + ".tmp";
+
+    std::FILE* f = std::fopen(tmp.c_str(), "w");
+    if (!f) {
+        error = "Cannot open " + tmp + " for writing.";
+        return false;
+    }
+    bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+    if (std::fclose(f) != 0) ok = false;
+    if (ok && std::rename(tmp.c_str(), path.c_str()) != 0) {
+        // Windows will not rename over an existing file
+        std::remove(path.c_str());
+        ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+    if (!ok) {
+        std::remove(tmp.c_str());
+        error = "Failed writing " + path + ".";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,132 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Monotonic count. Updates are relaxed atomics: safe from any
+ * thread, no ordering with anything else.
+ */
+class Counter
+{
+public:
+    void add(std::uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value { 0 };
+};
+
+/**
+ * @brief Point-in-time value.
+ */
+class Gauge
+{
+public:
+    void set(double v) { value.store(v, std::memory_order_relaxed); }
+    double get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> value { 0.0 };
+};
+
+/**
+ * @brief HDR-style latency histogram over nanoseconds.
+ *
+ * Values below 2^subBucketBits get one bucket each; above that, every
+ * power of two is split into 2^subBucketBits linear sub-buckets, so any
+ * recorded value is known to within 1/32 (~3%) across the full 64-bit
+ * range in a fixed 1920-bucket array. record() is a few relaxed atomic
+ * adds and never allocates; quantiles are computed by the reader.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr int subBucketBits = 5;
+    static constexpr int subBucketCount = 1 << subBucketBits;
+    static constexpr int bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+
+    void record(std::uint64_t ns);
+
+    std::uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    std::uint64_t sum() const { return sumNs.load(std::memory_order_relaxed); }
+    std::uint64_t max() const { return maxNs.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Value at quantile q (0..1), as the upper edge of the bucket
+     * holding it. 0 when empty.
+     */
+    std::uint64_t quantile(double q) const;
+
+    /**
+     * @brief Recorded values strictly above thresholdNs, to bucket precision.
+     */
+    std::uint64_t countAbove(std::uint64_t thresholdNs) const;
+
+    static int bucketIndex(std::uint64_t ns);
+    static std::uint64_t bucketUpperBound(int index);
+
+private:
+    std::array<std::atomic<std::uint64_t>, bucketCount> buckets {};
+    std::atomic<std::uint64_t> total { 0 };
+    std::atomic<std::uint64_t> sumNs { 0 };
+    std::atomic<std::uint64_t> maxNs { 0 };
+};
+
+/**
+ * @brief MetricsRegistry names metrics and renders them in the
+ * Prometheus text exposition format. Registration takes a lock and
+ * returns a reference that stays valid for the registry's lifetime;
+ * updates through it are lock-free. Metrics sharing a name form one
+ * family and differ by their label set, e.g. outcome="suspend".
+ */
+class MetricsRegistry
+{
+public:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+    Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    /**
+     * @brief Rendered as a summary in seconds (quantiles, _sum, _count)
+     * plus a <name>_max gauge.
+     */
+    LatencyHistogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    std::string renderText() const;
+
+    /**
+     * @brief writeText renders to a temporary file and renames it over
+     * path, so a reader (e.g. a textfile collector) never sees half a dump.
+     */
+    bool writeText(const std::string& path, std::string& error) const;
+
+private:
+    enum class Kind { Counter, Gauge, Histogram };
+
+    struct Entry {
+        Kind kind;
+        std::string name;
+        std::string help;
+        std::string labels;
+        Counter counterValue;
+        Gauge gaugeValue;
+        std::unique_ptr<LatencyHistogram> histogramValue;  // histograms only, ~15 KB each
+    };
+
+    Entry& add(Kind kind, const std::string& name, const std::string& help, const std::string& labels);
+
+    mutable std::mutex mutex;
+    std::deque<Entry> entries;  // deque: references stay valid as it grows
+};
+
+#endif // METRICS_H
@@ -0,0 +1,162 @@
+#include "MpcPolicy.h"
+#include "BinaryIo.h"
+#include "BoxQp.h"
+#include <cmath>
+
+namespace {
+
+constexpr int N = MpcPolicy::horizonSteps;
+constexpr int M = MpcPolicy::controlMoves;
+
+/**
+ * @brief The patient-independent part of the prediction model.
+ *
+ * response[k][j]: insulin (U) acted by step k per 1 U/h held over
+ * move j. bg[k] = free[k] - isf * basal * response[k] . v for plan v.
+ * gram = response' response, so H = (isf*basal)^2 gram + penalties.
+ * The linear term is a sum over the horizon of response times the
+ * residual from target; the residual is affine in (bg - target), slope,
+ * IOB and COB, so the four column sums are precomputed and f costs O(M).
+ */
+struct MpcModel {
+    double response[N][M];
+    double gram[M][M];
+    double iobActed[N];      // fraction of current IOB acted by step k
+    double carbActed[N];     // fraction of current COB absorbed by step k
+    double trendMinutes[N];  // minutes of current slope carried to step k
+    double sumResponse[M];         // sum_k response[k][j]
+    double sumResponseTrend[M];    // sum_k response[k][j] * trendMinutes[k]
+    double sumResponseIob[M];      // sum_k response[k][j] * iobActed[k]
+    double sumResponseCarb[M];     // sum_k response[k][j] * carbActed[k]
+
+    MpcModel()
+    {
+        const double decay = std::exp(-MpcPolicy::stepMinutes / MpcPolicy::tauMinutes);
+        const double fade = std::exp(-MpcPolicy::stepMinutes / MpcPolicy::trendTauMinutes);
+        const double carbDecay = std::exp(-MpcPolicy::stepMinutes / MpcPolicy::carbTauMinutes);
+        const double unitsPerStep = MpcPolicy::stepMinutes / 60.0;
+
+        // Insulin added at step i has acted 1 - decay^(k-i+1) of itself by step k
+        double carried = 0.0, fadeK = 1.0, decayK = 1.0, carbK = 1.0;
+        for (int k = 0; k < N; ++k) {
+            decayK *= decay;
+            iobActed[k] = 1.0 - decayK;
+            carbK *= carbDecay;
+            carbActed[k] = 1.0 - carbK;
+            fadeK *= fade;
+            carried += MpcPolicy::stepMinutes * fadeK;
+            trendMinutes[k] = carried;
+
+            for (int j = 0; j < M; ++j) {
+                double acted = 0.0;
+                for (int i = j * MpcPolicy::blockSteps; i < (j + 1) * MpcPolicy::blockSteps && i <= k; ++i) {
+                    acted += 1.0 - std::pow(decay, k - i + 1);
+                }
+                response[k][j] = unitsPerStep * acted;
+            }
+        }
+        for (int a = 0; a < M; ++a) {
+            sumResponse[a] = sumResponseTrend[a] = sumResponseIob[a] = sumResponseCarb[a] = 0.0;
+            for (int k = 0; k < N; ++k) {
+                sumResponse[a] += response[k][a];
+                sumResponseTrend[a] += response[k][a] * trendMinutes[k];
+                sumResponseIob[a] += response[k][a] * iobActed[k];
+                sumResponseCarb[a] += response[k][a] * carbActed[k];
+            }
+            for (int b = 0; b < M; ++b) {
+                double sum = 0.0;
+                for (int k = 0; k < N; ++k) sum += response[k][a] * response[k][b];
+                gram[a][b] = sum;
+            }
+        }
+    }
+};
+
+const MpcModel& model()
+{
+    static const MpcModel instance;
+    return instance;
+}
+
+} // namespace
+
+MpcPolicy::MpcPolicy()
+    : plan {}
+    , lastSweeps(0)
+{
+}
+
+ControllerDecision MpcPolicy::decide(const ControllerInput& in)
+{
+    ControllerDecision d;
+    lastSweeps = 0;
+    if (!in.hasTrend) {
+        return d;
+    }
+
+    const MpcModel& m = model();
+    const double basal = in.settings.basalRate;
+    const double isf = in.settings.correctionFactor;
+    const double target = in.settings.targetGlucose;
+    const double slopePerMin = in.trend;
+    const double carbRise = in.settings.carbRatio > 0.0 ? isf / in.settings.carbRatio * in.carbsOnBoard : 0.0;
+
+    d.predictedBg = in.bg + slopePerMin * 30.0;
+    if (basal <= 0.0) {
+        // Nothing scheduled, so no rate to scale
+        return d;
+    }
+
+    // Residual from target with the schedule unchanged: e[k] = free[k] - target
+    // J(v) = sum (e - g R v)^2 + ratePenalty |v|^2 + movePenalty sum (v[j] - v[j-1])^2
+    const double gain = isf * basal;
+    BoxQp<M> qp;
+    for (int j = 0; j < M; ++j) {
+        qp.f[j] = -gain * ((in.bg - target) * m.sumResponse[j]
+                           + (slopePerMin - carbRise / carbTauMinutes) * m.sumResponseTrend[j]
+                           - isf * in.insulinOnBoard * m.sumResponseIob[j]
+                           + carbRise * m.sumResponseCarb[j]);
+        for (int l = 0; l < M; ++l) {
+            qp.H[j][l] = gain * gain * m.gram[j][l];
+        }
+        // Move j differs from move j-1 (move -1 being the schedule) and j+1
+        qp.H[j][j] += ratePenalty + movePenalty * (j == M - 1 ? 1.0 : 2.0);
+        if (j > 0) {
+            qp.H[j][j - 1] -= movePenalty;
+            qp.H[j - 1][j] -= movePenalty;
+        }
+        qp.lo[j] = -1.0;
+        qp.hi[j] = maxMultiplier - 1.0;
+    }
+    // Warm start from last decision's plan, shifted one move along
+    for (int j = 0; j + 1 < M; ++j) plan[j] = plan[j + 1];
+    lastSweeps = qp.solve(plan, maxSweeps, 1e-4);
+
+    const double rate = basal * (1.0 + plan[0]);
+    if (rate < 0.05) {
+        d.action = ControlAction::SuspendBasal;
+    } else if (std::fabs(rate - basal) > 0.1 * basal) {
+        d.action = ControlAction::AdjustBasal;
+        d.basalRate = rate;
+    }
+    return d;
+}
+
+void MpcPolicy::saveState(BinaryWriter& out) const
+{
+    for (double move : plan) {
+        out.put(move);
+    }
+    out.put<std::int32_t>(lastSweeps);
+}
+
+bool MpcPolicy::restoreState(BinaryReader& in)
+{
+    std::int32_t sweeps = 0;
+    for (double& move : plan) {
+        if (!in.get(move)) return false;
+    }
+    if (!in.get(sweeps)) return false;
+    lastSweeps = sweeps;
+    return true;
+}
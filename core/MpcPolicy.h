@@ -0,0 +1,59 @@
+#ifndef MPCPOLICY_H
+#define MPCPOLICY_H
+
+#include <array>
+#include "ControllerPolicy.h"
+
+/**
+ * @brief Model-predictive basal controller.
+ *
+ * Plans the basal rate for the next two hours as six 20-minute moves,
+ * each a multiplier of the scheduled rate in [0, maxMultiplier]. The
+ * glucose model is linear: the current trend fading with time constant
+ * trendTauMinutes, minus the correction factor times insulin acted,
+ * where insulin (on board or planned) acts as a first-order delay with
+ * time constant tauMinutes, plus the carbs on board, absorbed first-order
+ * with carbTauMinutes, times correction factor / carb ratio. The cost is squared distance from target at
+ * every 5-minute step plus penalties on moving off schedule and on
+ * changing rate between moves, which makes a small box-constrained QP
+ * (see BoxQp.h). The model's step response is built once; per decision
+ * only the linear term depends on the patient, so a decide() does no
+ * allocation. The first move is applied and the plan is kept to
+ * warm-start the next solve.
+ */
+class MpcPolicy
+{
+public:
+    static constexpr int horizonSteps = 24;      // 24 x 5 min = 2 h
+    static constexpr int blockSteps = 4;         // steps per control move
+    static constexpr int controlMoves = horizonSteps / blockSteps;
+    static constexpr double stepMinutes = 5.0;
+    static constexpr double tauMinutes = 55.0;
+    static constexpr double trendTauMinutes = 45.0;
+    static constexpr double carbTauMinutes = 40.0;
+    static constexpr double maxMultiplier = 4.0;
+    static constexpr double ratePenalty = 2.0;   // per (multiplier - 1)^2
+    static constexpr double movePenalty = 1.0;   // per change between moves
+    static constexpr int maxSweeps = 50;
+
+    MpcPolicy();
+
+    ControllerDecision decide(const ControllerInput& in);
+
+    /**
+     * @brief Checkpoint support: the warm-start plan.
+     */
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+    /**
+     * @brief Gauss-Seidel sweeps used by the last solve (0 if none ran).
+     */
+    int getLastSweeps() const { return lastSweeps; }
+
+private:
+    std::array<double, controlMoves> plan;  // multiplier - 1 per move
+    int lastSweeps;
+};
+
+#endif // MPCPOLICY_H
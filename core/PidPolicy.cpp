@@ -0,0 +1,56 @@
+#include "PidPolicy.h"
+#include "BinaryIo.h"
+#include <algorithm>
+#include <cmath>
+
+PidPolicy::PidPolicy()
+    : PidPolicy(Gains())
+{
+}
+
+PidPolicy::PidPolicy(const Gains& gains)
+    : gains(gains)
+    , integral(0.0)
+{
+}
+
+ControllerDecision PidPolicy::decide(const ControllerInput& in)
+{
+    ControllerDecision d;
+    if (!in.hasTrend) {
+        return d;
+    }
+
+    const double basal = in.settings.basalRate;
+    const double error = in.bg - in.settings.targetGlucose;
+    const double slopePerHour = in.trend * 60.0;
+
+    integral = std::clamp(integral + error * in.dtMinutes / 60.0,
+                          -gains.integralLimit, gains.integralLimit);
+
+    double rate = basal * (1.0 + gains.kp * error + gains.ki * integral + gains.kd * slopePerHour)
+                - gains.gamma * in.insulinOnBoard;
+    rate = std::clamp(rate, 0.0, 4.0 * basal);
+
+    d.predictedBg = in.bg + slopePerHour * 0.5;
+    if (rate < 0.05) {
+        d.action = ControlAction::SuspendBasal;
+    } else if (std::fabs(rate - basal) > 0.1 * basal) {
+        d.action = ControlAction::AdjustBasal;
+        d.basalRate = rate;
+    }
+    return d;
+}
+
+/**
+ * @brief Only the integral is state; the gains come with the policy.
+ */
+void PidPolicy::saveState(BinaryWriter& out) const
+{
+    out.put(integral);
+}
+
+bool PidPolicy::restoreState(BinaryReader& in)
+{
+    return in.get(integral);
+}
@@ -0,0 +1,39 @@
+#ifndef PIDPOLICY_H
+#define PIDPOLICY_H
+
+#include "ControllerPolicy.h"
+
+/**
+ * @brief PID basal controller with insulin feedback.
+ *
+ * rate = basal * (1 + kp*e + ki*integral(e) + kd*dBG/dt) - gamma * IOB
+ * where e = BG - target (mmol/L), time in hours. The insulin feedback
+ * term backs the rate off while earlier insulin is still acting. The
+ * integral is clamped against windup and the rate to [0, 4x basal].
+ * Rates within 10% of the schedule are left alone.
+ */
+class PidPolicy
+{
+public:
+    struct Gains {
+        double kp = 0.25;          // per mmol/L
+        double ki = 0.05;          // per mmol/L*h
+        double kd = 0.5;           // per mmol/L/h
+        double gamma = 0.5;        // U/h per U on board
+        double integralLimit = 10.0;
+    };
+
+    PidPolicy();
+    explicit PidPolicy(const Gains& gains);
+
+    ControllerDecision decide(const ControllerInput& in);
+
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    Gains gains;
+    double integral;
+};
+
+#endif // PIDPOLICY_H
@@ -0,0 +1,333 @@
+#include "ProfileStore.h"
+#include "BinaryIo.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char storeMagic[4] = { 'T', 'P', 'P', 'S' };
+const std::uint32_t storeFormatVersion = 1;
+const std::size_t headerSize = 4 + 4 + 8 + 8 + 8;
+const std::size_t indexEntrySize = 8 + 8 + 4 + 4;
+
+bool decodeSettings(BinaryReader& in, TherapySettings& s)
+{
+    return in.get(s.basalRate) && in.get(s.carbRatio)
+        && in.get(s.correctionFactor) && in.get(s.targetGlucose);
+}
+
+} // namespace
+
+void encodeProfile(BinaryWriter& out, const UserProfile& p)
+{
+    out.putString(p.name);
+    out.put(p.basalRate);
+    out.put(p.carbRatio);
+    out.put(p.correctionFactor);
+    out.put(p.targetGlucose);
+    out.put(p.safetyLimits.maxSingleBolus);
+    out.put(p.safetyLimits.maxDailyBolus);
+    out.put(p.safetyLimits.cooldownMinutes);
+    out.put(p.safetyLimits.maxInsulinOnBoard);
+    out.put(p.safetyLimits.bgLockout);
+    out.put<std::uint32_t>(static_cast<std::uint32_t>(p.segments.size()));
+    for (const TherapySegment& seg : p.segments) {
+        out.put<std::int32_t>(seg.startMinute);
+        out.put(seg.settings.basalRate);
+        out.put(seg.settings.carbRatio);
+        out.put(seg.settings.correctionFactor);
+        out.put(seg.settings.targetGlucose);
+    }
+}
+
+bool decodeProfile(BinaryReader& in, UserProfile& p)
+{
+    std::uint32_t nameLen = 0, segCount = 0;
+    TherapySettings base;
+    if (!in.get(nameLen) || !in.getBytes(p.name, nameLen) || !decodeSettings(in, base))
+        return false;
+    p.basalRate = base.basalRate;
+    p.carbRatio = base.carbRatio;
+    p.correctionFactor = base.correctionFactor;
+    p.targetGlucose = base.targetGlucose;
+
+    SafetyLimits& l = p.safetyLimits;
+    if (!in.get(l.maxSingleBolus) || !in.get(l.maxDailyBolus) || !in.get(l.cooldownMinutes)
+        || !in.get(l.maxInsulinOnBoard) || !in.get(l.bgLockout) || !in.get(segCount))
+        return false;
+    if (segCount > static_cast<std::uint32_t>(UserProfile::maxSegments))
+        return false;
+
+    p.segments.resize(segCount);
+    for (TherapySegment& seg : p.segments) {
+        std::int32_t start = 0;
+        if (!in.get(start) || !decodeSettings(in, seg.settings)) return false;
+        seg.startMinute = start;
+    }
+    return true;
+}
+
+ProfileStore::ProfileStore()
+    : nextId(1)
+    , dirty(false)
+{
+}
+
+/**
+ * @brief open replaces the store's contents with the file's index.
+ * On failure the store is left empty and error says why.
+ */
+bool ProfileStore::open(const std::string& path, std::string& error)
+{
+    clear();
+    file.close();
+    file.clear();
+    file.open(path, std::ios::binary);
+    if (!file) {
+        error = "Cannot open " + path;
+        return false;
+    }
+
+    char header[headerSize];
+    if (!file.read(header, headerSize) || std::memcmp(header, storeMagic, 4) != 0) {
+        error = path + " is not a profile store";
+        return false;
+    }
+    BinaryReader h(header + 4, headerSize - 4);
+    std::uint32_t version = 0;
+    std::uint64_t count = 0, indexOffset = 0, storedNextId = 0;
+    h.get(version);
+    h.get(count);
+    h.get(indexOffset);
+    h.get(storedNextId);
+    if (version != storeFormatVersion) {
+        error = "Unsupported profile store version " + std::to_string(version);
+        return false;
+    }
+
+    // Check the header against the file before sizing buffers from it,
+    // so a truncated or corrupt file is an error, not a huge allocation
+    if (!file.seekg(0, std::ios::end)) {
+        error = "Cannot read " + path;
+        return false;
+    }
+    const std::uint64_t fileSize = static_cast<std::uint64_t>(file.tellg());
+    if (indexOffset < headerSize || indexOffset > fileSize
+        || count > (fileSize - indexOffset) / indexEntrySize) {
+        error = path + " is truncated or corrupt (index)";
+        return false;
+    }
+
+    // Index table and name blob: two bulk reads, no per-profile I/O
+    std::string index(count * indexEntrySize, '\0');
+    if (!file.seekg(static_cast<std::streamoff>(indexOffset))
+        || !file.read(&index[0], static_cast<std::streamsize>(index.size()))) {
+        error = path + " is truncated (index)";
+        return false;
+    }
+
+    std::uint64_t namesSize = 0;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint32_t len = 0;
+        std::memcpy(&len, index.data() + i * indexEntrySize + 16, sizeof(len));
+        namesSize += len;
+    }
+    if (namesSize > fileSize - indexOffset - index.size()) {
+        error = path + " is truncated (names)";
+        return false;
+    }
+    std::string names(namesSize, '\0');
+    if (namesSize > 0 && !file.read(&names[0], static_cast<std::streamsize>(namesSize))) {
+        error = path + " is truncated (names)";
+        return false;
+    }
+
+    entries.resize(count);
+    BinaryReader idx(index.data(), index.size());
+    std::size_t namePos = 0;
+    for (Entry& e : entries) {
+        std::uint32_t len = 0, reserved = 0;
+        idx.get(e.id);
+        idx.get(e.recordOffset);
+        idx.get(len);
+        idx.get(reserved);
+        e.name.assign(names, namePos, len);
+        namePos += len;
+    }
+
+    nextId = storedNextId;
+    rebuildIndexes();
+    dirty = false;
+    return true;
+}
+
+/**
+ * @brief save writes every profile to path (via a temporary file that
+ * replaces it), then serves later lazy reads from the new file.
+ */
+bool ProfileStore::save(const std::string& path, std::string& error)
+{
+    std::string records;
+    BinaryWriter recordWriter(records);
+    std::vector<std::uint64_t> offsets(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        offsets[i] = headerSize + records.size();
+        encodeProfile(recordWriter, get(i));
+    }
+
+    std::string out;
+    out.reserve(headerSize + records.size() + entries.size() * (indexEntrySize + 16));
+    BinaryWriter w(out);
+    w.putBytes(storeMagic, 4);
+    w.put(storeFormatVersion);
+    w.put<std::uint64_t>(entries.size());
+    w.put<std::uint64_t>(headerSize + records.size());
+    w.put(nextId);
+    out.append(records);
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        w.put(entries[i].id);
+        w.put(offsets[i]);
+        w.put<std::uint32_t>(static_cast<std::uint32_t>(entries[i].name.size()));
+        w.put<std::uint32_t>(0);
+    }
+    for (const Entry& e : entries) {
+        out.append(e.name);
+    }
+
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream tmp(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!tmp.write(out.data(), static_cast<std::streamsize>(out.size()))) {
+            error = "Cannot write " + tmpPath;
+            return false;
+        }
+    }
+    // rename replaces path atomically on POSIX, so a crash leaves either
+    // the old library or the new one. Windows will not rename over an
+    // existing file, so there it has to go first.
+    file.close();
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        error = "Cannot replace " + path;
+        file.clear();
+        file.open(path, std::ios::binary);
+        return false;
+    }
+
+    file.clear();
+    file.open(path, std::ios::binary);
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        entries[i].recordOffset = offsets[i];
+    }
+    dirty = false;
+    return true;
+}
+
+long long ProfileStore::findById(std::uint64_t id) const
+{
+    auto it = byId.find(id);
+    return it == byId.end() ? -1 : static_cast<long long>(it->second);
+}
+
+long long ProfileStore::findByName(const std::string& name) const
+{
+    auto it = byName.find(name);
+    return it == byName.end() ? -1 : static_cast<long long>(it->second);
+}
+
+const UserProfile& ProfileStore::get(std::size_t slot)
+{
+    Entry& e = entries[slot];
+    if (e.loaded) {
+        return *e.loaded;
+    }
+
+    std::unique_ptr<UserProfile> profile(new UserProfile());
+    bool ok = false;
+    if (e.recordOffset != 0 && file.is_open()) {
+        // The record size is not stored; read the fixed part, then the segments
+        const std::size_t fixedTail = 9 * sizeof(double) + sizeof(std::uint32_t);
+        const std::size_t segmentSize = sizeof(std::int32_t) + 4 * sizeof(double);
+        std::string buf(sizeof(std::uint32_t) + e.name.size() + fixedTail, '\0');
+        file.clear();
+        if (file.seekg(static_cast<std::streamoff>(e.recordOffset))
+            && file.read(&buf[0], static_cast<std::streamsize>(buf.size()))) {
+            std::uint32_t segCount = 0;
+            std::memcpy(&segCount, buf.data() + buf.size() - sizeof(segCount), sizeof(segCount));
+            if (segCount <= static_cast<std::uint32_t>(UserProfile::maxSegments)) {
+                std::size_t fixed = buf.size();
+                buf.resize(fixed + segCount * segmentSize);
+                if (segCount == 0 || file.read(&buf[fixed], static_cast<std::streamsize>(segCount * segmentSize))) {
+                    BinaryReader in(buf.data(), buf.size());
+                    ok = decodeProfile(in, *profile);
+                }
+            }
+        }
+    }
+    if (!ok) {
+        // Unreadable record: keep the name so the entry can still be fixed or deleted
+        profile.reset(new UserProfile());
+        profile->name = e.name;
+    }
+
+    e.loaded = std::move(profile);
+    return *e.loaded;
+}
+
+std::uint64_t ProfileStore::add(const UserProfile& profile)
+{
+    Entry e;
+    e.id = nextId++;
+    e.name = profile.name;
+    e.recordOffset = 0;
+    e.loaded.reset(new UserProfile(profile));
+    entries.push_back(std::move(e));
+    indexEntry(entries.size() - 1);
+    dirty = true;
+    return entries.back().id;
+}
+
+void ProfileStore::update(std::size_t slot, const UserProfile& profile)
+{
+    Entry& e = entries[slot];
+    if (e.name != profile.name) {
+        e.name = profile.name;
+        rebuildIndexes();
+    }
+    e.loaded.reset(new UserProfile(profile));
+    dirty = true;
+}
+
+void ProfileStore::remove(std::size_t slot)
+{
+    entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(slot));
+    rebuildIndexes();
+    dirty = true;
+}
+
+void ProfileStore::clear()
+{
+    entries.clear();
+    byId.clear();
+    byName.clear();
+    dirty = true;
+}
+
+void ProfileStore::rebuildIndexes()
+{
+    byId.clear();
+    byName.clear();
+    byId.reserve(entries.size());
+    byName.reserve(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        indexEntry(i);
+    }
+}
+
+void ProfileStore::indexEntry(std::size_t slot)
+{
+    byId[entries[slot].id] = slot;
+    byName.emplace(entries[slot].name, slot);   // keeps the first of duplicate names
+}
@@ -0,0 +1,90 @@
+#ifndef PROFILESTORE_H
+#define PROFILESTORE_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "UserProfile.h"
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief ProfileStore is an indexed, persistent collection of profiles,
+ * sized for virtual-patient libraries of 100k+ entries.
+ *
+ * On-disk format (host byte order, little-endian on every target we build):
+ *   header   "TPPS", u32 format version, u64 count, u64 index offset, u64 next id
+ *   records  per profile: u32 name length, name, 4 doubles base settings,
+ *            5 doubles safety limits, u32 segment count, then per segment
+ *            i32 start minute and 4 doubles
+ *   index    per profile: u64 id, u64 record offset, u32 name length, u32 0
+ *   names    all names back to back
+ *
+ * open() reads only the header, index and names (two bulk reads) and builds
+ * id and name hash indexes; a profile record is read and decoded the first
+ * time get() asks for it. Slots are positions in the store's order.
+ * Not thread-safe: UserProfileManager serialises writers.
+ */
+class ProfileStore
+{
+public:
+    ProfileStore();
+
+    bool open(const std::string& path, std::string& error);
+    bool save(const std::string& path, std::string& error);
+
+    std::size_t size() const { return entries.size(); }
+    bool isDirty() const { return dirty; }
+
+    std::uint64_t idAt(std::size_t slot) const { return entries[slot].id; }
+    const std::string& nameAt(std::size_t slot) const { return entries[slot].name; }
+
+    /**
+     * @return the slot of the profile, or -1 if there is none. With duplicate
+     * names, findByName returns the first.
+     */
+    long long findById(std::uint64_t id) const;
+    long long findByName(const std::string& name) const;
+
+    /**
+     * @brief get decodes the profile on first access and caches it.
+     */
+    const UserProfile& get(std::size_t slot);
+
+    std::uint64_t add(const UserProfile& profile);
+    void update(std::size_t slot, const UserProfile& profile);
+    void remove(std::size_t slot);
+    void clear();
+
+private:
+    struct Entry {
+        std::uint64_t id;
+        std::string name;
+        std::uint64_t recordOffset;            // 0 = not on disk
+        std::unique_ptr<UserProfile> loaded;
+    };
+
+    std::vector<Entry> entries;
+    std::unordered_map<std::uint64_t, std::size_t> byId;
+    std::unordered_map<std::string, std::size_t> byName;
+    std::uint64_t nextId;
+    bool dirty;
+
+    std::ifstream file;
+
+    void rebuildIndexes();
+    void indexEntry(std::size_t slot);
+};
+
+/**
+ * @brief One profile record in the store's format; also used to carry the
+ * active profile in simulation checkpoints.
+ */
+void encodeProfile(BinaryWriter& out, const UserProfile& profile);
+bool decodeProfile(BinaryReader& in, UserProfile& profile);
+
+#endif // PROFILESTORE_H
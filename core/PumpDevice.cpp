@@ -0,0 +1,137 @@
+#include "PumpDevice.h"
+#include "BinaryIo.h"
+#include "HistoryRecord.h"
+#include "StringUtil.h"
+#include <algorithm>
+#include <cmath>
+
+PumpDevice::PumpDevice(SimClock* clock, HistoryManager* hist)
+    : simClock(clock),
+      history(hist),
+      reservoir(200.0),
+      battery(100.0)
+{
+}
+
+int PumpDevice::getBatteryPercent() const
+{
+    return static_cast<int>(std::ceil(battery - 1e-9));
+}
+
+void PumpDevice::setReservoir(double units)
+{
+    double before = reservoir;
+    reservoir = std::max(0.0, units);
+    reservoirChanged(before, reservoir, 0);
+}
+
+void PumpDevice::setBatteryLevel(double percent)
+{
+    double before = battery;
+    battery = std::clamp(percent, 0.0, 100.0);
+    batteryChanged(before, battery, 0);
+}
+
+double PumpDevice::deliverBolus(double units)
+{
+    double delivered = std::min(std::max(units, 0.0), reservoir);
+    if (delivered <= 0.0) return 0.0;
+
+    double before = reservoir;
+    reservoir -= delivered;
+    reservoirChanged(before, reservoir, 0);
+
+    before = battery;
+    battery = std::max(0.0, battery - motorDrainPerUnit * delivered);
+    batteryChanged(before, battery, 0);
+    return delivered;
+}
+
+/**
+ * @brief run drains both levels linearly over the interval, so a
+ * crossing inside it is placed at the minute the level reached the
+ * threshold rather than at the end.
+ */
+double PumpDevice::run(int minutes, double units)
+{
+    double infused = std::min(std::max(units, 0.0), reservoir);
+    if (infused > 0.0) {
+        double before = reservoir;
+        reservoir -= infused;
+        reservoirChanged(before, reservoir, minutes);
+    }
+
+    double drain = idleDrainPerMinute * minutes + motorDrainPerUnit * infused;
+    if (drain > 0.0 && battery > 0.0) {
+        double before = battery;
+        battery = std::max(0.0, battery - drain);
+        batteryChanged(before, battery, minutes);
+    }
+    return infused;
+}
+
+void PumpDevice::radioReading()
+{
+    if (battery <= 0.0) return;
+    double before = battery;
+    battery = std::max(0.0, battery - radioDrainPerReading);
+    batteryChanged(before, battery, 0);
+}
+
+std::deque<DeviceAlert> PumpDevice::takeAlerts()
+{
+    std::deque<DeviceAlert> alerts;
+    alerts.swap(pending);
+    return alerts;
+}
+
+// Two comparisons on every change; everything else only runs on a crossing
+void PumpDevice::batteryChanged(double before, double after, int minutes)
+{
+    if (before > batteryCriticalPercent && after <= batteryCriticalPercent) {
+        alert(before, after, minutes, batteryCriticalPercent, DeviceAlertKind::BatteryCritical, "Battery critically low!");
+    } else if (before > batteryLowPercent && after <= batteryLowPercent) {
+        alert(before, after, minutes, batteryLowPercent, DeviceAlertKind::BatteryLow, "Battery low!");
+    }
+}
+
+void PumpDevice::reservoirChanged(double before, double after, int minutes)
+{
+    if (before > reservoirCriticalUnits && after <= reservoirCriticalUnits) {
+        alert(before, after, minutes, reservoirCriticalUnits, DeviceAlertKind::ReservoirCritical, "Insulin critically low!");
+    } else if (before > reservoirLowUnits && after <= reservoirLowUnits) {
+        alert(before, after, minutes, reservoirLowUnits, DeviceAlertKind::ReservoirLow, "Insulin low!");
+    }
+}
+
+void PumpDevice::alert(double before, double after, int minutes, double threshold,
+                       DeviceAlertKind kind, const char* message)
+{
+    const SimTime now = simClock->now();
+    SimTime time = now;
+    if (minutes > 0) {
+        double fraction = (before - threshold) / (before - after);
+        time = now - minutes + static_cast<long long>(std::ceil(fraction * minutes - 1e-9));
+    }
+
+    // History stays in time order: the record is stamped now and the
+    // crossing, if earlier, goes in its note
+    if (history) {
+        std::string note = message;
+        if (time != now) note += " (crossed at " + formatTimeOfDay(time) + ")";
+        history->addRecord({ now, RecordType::Warning, 0.0, note });
+    }
+    pending.push_back({ time, kind, message });
+    if (pending.size() > maxPendingAlerts) pending.pop_front();
+}
+
+void PumpDevice::saveState(BinaryWriter& out) const
+{
+    out.put(reservoir);
+    out.put(battery);
+}
+
+bool PumpDevice::restoreState(BinaryReader& in)
+{
+    return in.get(reservoir) && in.get(battery);
+}
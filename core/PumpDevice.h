@@ -0,0 +1,127 @@
+#ifndef PUMPDEVICE_H
+#define PUMPDEVICE_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include "HistoryManager.h"
+#include "SimClock.h"
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief A reservoir or battery threshold the pump warns about.
+ */
+enum class DeviceAlertKind : std::uint8_t {
+    BatteryLow,
+    BatteryCritical,
+    ReservoirLow,
+    ReservoirCritical
+};
+
+/**
+ * @brief A threshold crossing, stamped with the simulated time it happened.
+ */
+struct DeviceAlert {
+    SimTime time;
+    DeviceAlertKind kind;
+    std::string message;
+};
+
+/**
+ * @brief PumpDevice models the pump hardware's consumables: every unit
+ * delivered comes out of the reservoir, and the battery drains while
+ * idle, for each CGM radio exchange and for each unit the motor pushes.
+ *
+ * Warnings are edge-triggered: a level is only compared with its
+ * thresholds when it changes, and an alert fires once, when it goes
+ * from above a threshold to at or below it (only the most severe if a
+ * change crosses both). For a continuous draw the alert is stamped with
+ * the minute the level crossed, interpolated within the interval, so
+ * nothing is missed or delayed as a periodic check would. Raising a
+ * level (refill, new battery) re-arms the thresholds above it.
+ *
+ * Alerts are queued (the last maxPendingAlerts) for a front end to show;
+ * see takeAlerts(). They are also logged as warnings stamped now, so the
+ * history stays in time order, with an earlier crossing time in the note.
+ */
+class PumpDevice
+{
+public:
+    static constexpr double batteryLowPercent = 20.0;
+    static constexpr double batteryCriticalPercent = 5.0;
+    static constexpr double reservoirLowUnits = 20.0;
+    static constexpr double reservoirCriticalUnits = 5.0;
+
+    // Battery use in % of a full charge: about six days at 50 U/day
+    static constexpr double idleDrainPerMinute = 0.006;
+    static constexpr double radioDrainPerReading = 0.02;
+    static constexpr double motorDrainPerUnit = 0.05;
+
+    static constexpr std::size_t maxPendingAlerts = 16;
+
+    PumpDevice(SimClock* clock, HistoryManager* hist);
+
+    double getReservoir() const { return reservoir; }
+    double getBatteryLevel() const { return battery; }
+
+    /**
+     * @brief Battery as the pump shows it: whole percent, rounded up so
+     * 0% means empty.
+     */
+    int getBatteryPercent() const;
+
+    /**
+     * @brief Set a level directly (scenario, refill, battery swap); a
+     * drop through a threshold alerts as any other.
+     */
+    void setReservoir(double units);
+    void setBatteryLevel(double percent);
+
+    /**
+     * @brief deliverBolus takes units from the reservoir now.
+     * @return the units actually delivered (less if it runs dry)
+     */
+    double deliverBolus(double units);
+
+    /**
+     * @brief run accounts for the minutes up to now: units infused evenly
+     * (basal, extended bolus) and the idle battery drain.
+     * @return the units actually infused
+     */
+    double run(int minutes, double units);
+
+    /**
+     * @brief radioReading drains the battery for one CGM exchange.
+     */
+    void radioReading();
+
+    /**
+     * @brief takeAlerts hands over the alerts raised since the last call.
+     */
+    std::deque<DeviceAlert> takeAlerts();
+    bool hasAlerts() const { return !pending.empty(); }
+
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    SimClock*       simClock;
+    HistoryManager* history;
+
+    double reservoir;   // U
+    double battery;     // % of a full charge
+    std::deque<DeviceAlert> pending;
+
+    /**
+     * @brief Alert if a level that went from before to after, over the
+     * minutes up to now (0: at once), crossed a threshold.
+     */
+    void batteryChanged(double before, double after, int minutes);
+    void reservoirChanged(double before, double after, int minutes);
+    void alert(double before, double after, int minutes, double threshold,
+               DeviceAlertKind kind, const char* message);
+};
+
+#endif // PUMPDEVICE_H
@@ -0,0 +1,331 @@
+#include "PumpEngine.h"
+#include "BinaryIo.h"
+#include "HistoryRecord.h"
+#include "StringUtil.h"
+#include "Trace.h"
+#include <algorithm>
+
+PumpEngine::PumpEngine(UserProfileManager* profileMgr,
+                       HistoryManager* histMgr,
+                       BolusSafetyManager* safetyMgr,
+                       CgmModel* cgm)
+    : userProfileManager(profileMgr),
+      historyManager(histMgr),
+      safetyManager(safetyMgr),
+      cgmModel(cgm),
+      device(nullptr),
+      carbs(nullptr),
+      metrics(nullptr),
+      telemetry(nullptr),
+      telemetryPump(0),
+      controllerKind(ControllerKind::Threshold),
+      controller(makeController(ControllerKind::Threshold)),
+      deliveredBasalRate(0.0),
+      scheduledBasalRate(0.0),
+      extendedRemaining(0.0),
+      extendedRate(0.0)
+{
+}
+
+void PumpEngine::setController(ControllerKind kind)
+{
+    controllerKind = kind;
+    controller = makeController(kind);
+}
+
+/**
+ * @brief requestBolus handles a manual bolus request (carbs/correction).
+ */
+bool PumpEngine::requestBolus(double totalBolus,
+                              const std::string& notes,
+                              double extendedFrac,
+                              int durationHrs)
+{
+    PUMP_TRACE_SCOPE("pump", "PumpEngine::requestBolus");
+    std::string errorMsg;
+    // First, check safety constraints
+    if (!checkBolus(totalBolus, errorMsg)) {
+        return false;
+    }
+
+    // If extendedFrac is between 0 and 1, we split. Otherwise, all is immediate
+    double immediate = totalBolus;
+    double extended  = 0.0;
+    if (extendedFrac > 0.0 && extendedFrac < 1.0) {
+        immediate = totalBolus * (1.0 - extendedFrac);
+        extended  = totalBolus * extendedFrac;
+    }
+
+    // Deliver immediate portion
+    deliver(immediate, DeliveryKind::ManualBolus);
+    historyManager->addRecord({
+        cgmModel->getSimTime(),
+        RecordType::ManualBolus,
+        immediate,
+        notes + " (Immediate portion)",
+        userProfileManager->getActiveVersion()
+    });
+
+    // The extended portion counts against the limits now and is infused
+    // evenly over the duration, a slice per CGM interval (accountBasal).
+    // A new extended bolus is added to any still running and the total
+    // restarts over the new duration.
+    if (extended > 0.0) {
+        if (durationHrs > 0) {
+            safetyManager->recordBolus(extended);
+            extendedRemaining += extended;
+            extendedRate = extendedRemaining / (durationHrs * 60.0);
+        } else {
+            deliver(extended, DeliveryKind::ManualBolus);
+        }
+        historyManager->addRecord({
+            cgmModel->getSimTime(),
+            RecordType::ManualBolus,
+            extended,
+            "Extended portion over " + std::to_string(durationHrs) + "hr",
+            userProfileManager->getActiveVersion()
+        });
+    }
+
+    return true;
+}
+
+/**
+ * @brief onCgmUpdated logs the reading and runs the ControlIQ algorithm.
+ * Records are stamped with the active profile version so history shows
+ * which settings each decision was made under.
+ */
+void PumpEngine::onCgmUpdated(double newBg)
+{
+    PUMP_TRACE_SCOPE("pump", "PumpEngine::onCgmUpdated");
+    // Log the CGM reading
+    historyManager->addRecord({
+        cgmModel->getSimTime(),
+        RecordType::CgmReading,
+        0.0,
+        "BG= " + formatFixed(newBg, 1) + " mmol/L",
+        userProfileManager->getActiveVersion()
+    });
+    if (telemetry) publish(TelemetryKind::CgmReading, 0, newBg, 0.0, 0.0);
+    if (device) device->radioReading();
+
+    // Book the basal delivered since the last reading, then run Control IQ logic
+    accountBasal(CgmModel::minutesPerTick);
+    runControlIQ(newBg);
+}
+
+const TherapySettings& PumpEngine::getCurrentSettings() const
+{
+    return userProfileManager->getActiveSnapshot()->schedule.at(cgmModel->getSimTime());
+}
+
+/**
+ * @brief accountBasal: net IOB counts basal relative to the schedule, so a
+ * suspension adds negative insulin and an increase adds the excess.
+ */
+void PumpEngine::accountBasal(double minutes)
+{
+    insulinOnBoard.advance(minutes);
+
+    double basal = deliveredBasalRate * minutes / 60.0;
+    double slice = extendedRemaining > 0.0 ? std::min(extendedRemaining, extendedRate * minutes) : 0.0;
+    if (device) {
+        // An empty reservoir delivers less than asked; the shortfall is shared
+        double wanted = basal + slice;
+        double infused = device->run(static_cast<int>(minutes), wanted);
+        if (infused < wanted) {
+            double share = wanted > 0.0 ? infused / wanted : 0.0;
+            basal *= share;
+            extendedRemaining -= slice * (1.0 - share);   // not delivered, not owed
+            slice *= share;
+        }
+    }
+    insulinOnBoard.add(basal - scheduledBasalRate * minutes / 60.0);
+
+    if (extendedRemaining > 0.0) {
+        extendedRemaining -= slice;
+        if (extendedRemaining < 1e-9) extendedRemaining = 0.0;
+        insulinOnBoard.add(slice);
+        if (metrics) metrics->insulinDeliveredMilliUnits.add(static_cast<std::uint64_t>(slice * 1000.0 + 0.5));
+        if (telemetry) {
+            publish(TelemetryKind::Delivery, static_cast<std::uint8_t>(DeliveryKind::ExtendedSlice),
+                    cgmModel->getCurrentBg(), slice, 0.0);
+        }
+    }
+}
+
+/**
+ * @brief runControlIQ feeds the policy the estimator's smoothed BG and
+ * trend, IOB, carbs on board and the scheduled settings, then logs and applies its decision.
+ */
+void PumpEngine::runControlIQ(double currentBg)
+{
+    PUMP_TRACE_SCOPE("pump", "PumpEngine::runControlIQ");
+    const GlucoseEstimator& estimator = cgmModel->getEstimator();
+    const TherapySettings& settings = getCurrentSettings();
+
+    ControllerInput in;
+    in.hasTrend = estimator.hasTrend();
+    in.bg = in.hasTrend ? estimator.smoothedBg() : currentBg;
+    in.trend = estimator.rateOfChange();
+    in.insulinOnBoard = insulinOnBoard.value();
+    in.carbsOnBoard = carbs ? carbs->getCarbsOnBoard() : 0.0;
+    in.dtMinutes = CgmModel::minutesPerTick;
+    in.settings = settings;
+
+    ControllerDecision d = decide(controller, in);
+    if (metrics) metrics->decision(d.action).add();
+
+    scheduledBasalRate = settings.basalRate;
+    deliveredBasalRate = settings.basalRate;
+    if (telemetry) {
+        double rate = d.action == ControlAction::SuspendBasal ? 0.0
+                    : d.action == ControlAction::AdjustBasal  ? d.basalRate
+                                                              : settings.basalRate;
+        publish(TelemetryKind::Decision, static_cast<std::uint8_t>(d.action), d.predictedBg,
+                d.action == ControlAction::AutoBolus ? d.bolusUnits : 0.0, rate);
+    }
+
+    switch (d.action) {
+    case ControlAction::SuspendBasal:
+        deliveredBasalRate = 0.0;
+        historyManager->addRecord({
+            cgmModel->getSimTime(),
+            RecordType::Other,
+            0.0,
+            "Basal suspended by Control-IQ (predBG= " + formatFixed(d.predictedBg, 1)
+                + ", scheduled " + formatFixed(settings.basalRate, 2) + " U/h)",
+            userProfileManager->getActiveVersion()
+        });
+        break;
+
+    case ControlAction::AutoBolus:
+        deliverAutoBolus(d.bolusUnits, "Auto correction (predBG= " + formatFixed(d.predictedBg, 1) + ")");
+        break;
+
+    case ControlAction::AdjustBasal:
+        deliveredBasalRate = d.basalRate;
+        historyManager->addRecord({
+            cgmModel->getSimTime(),
+            RecordType::Other,
+            0.0,
+            std::string(d.basalRate > settings.basalRate ? "Basal increased" : "Basal reduced")
+                + " by Control-IQ to " + formatFixed(d.basalRate, 2) + " U/h (predBG= "
+                + formatFixed(d.predictedBg, 1) + ", scheduled "
+                + formatFixed(settings.basalRate, 2) + " U/h)",
+            userProfileManager->getActiveVersion()
+        });
+        break;
+
+    case ControlAction::None:
+        break;
+    }
+}
+
+/**
+ * @brief checkBolus applies the active profile's limits, then evaluates
+ * the dose with IOB and the latest CGM reading filled in.
+ */
+bool PumpEngine::checkBolus(double units, std::string& errorMsg)
+{
+    safetyManager->setLimits(userProfileManager->getActiveProfile().safetyLimits);
+
+    BolusCandidate candidate = safetyManager->makeCandidate(units);
+    // Insulin committed to a running extended bolus counts as on board
+    candidate.insulinOnBoard = std::max(insulinOnBoard.value(), 0.0) + extendedRemaining;
+    if (device) candidate.reservoir = device->getReservoir();
+    if (!cgmModel->getLastSixReadings().empty()) {
+        candidate.bg = cgmModel->getCurrentBg();
+    }
+
+    BolusBlockReason reason = safetyManager->check(candidate);
+    if (reason == BolusBlockReason::None) {
+        return true;
+    }
+    if (metrics) metrics->blocked(reason).add();
+    if (telemetry) publish(TelemetryKind::BolusBlocked, static_cast<std::uint8_t>(reason), candidate.bg, units, 0.0);
+    errorMsg = describeBlockReason(reason, safetyManager->getLimits(), candidate);
+    return false;
+}
+
+/**
+ * @brief deliverAutoBolus tries an automatic bolus and logs it.
+ * If safety check fails, logs a warning.
+ */
+void PumpEngine::deliverAutoBolus(double units, const std::string& reason)
+{
+    std::string errorMsg;
+    if (!checkBolus(units, errorMsg)) {
+        // If we can't deliver it, log a warning
+        historyManager->addRecord({
+            cgmModel->getSimTime(),
+            RecordType::Warning,
+            0.0,
+            "Auto-bolus blocked: " + errorMsg,
+            userProfileManager->getActiveVersion()
+        });
+        return;
+    }
+    // Otherwise deliver it
+    deliver(units, DeliveryKind::AutoBolus);
+    historyManager->addRecord({
+        cgmModel->getSimTime(),
+        RecordType::AutoBolus,
+        units,
+        reason,
+        userProfileManager->getActiveVersion()
+    });
+}
+
+void PumpEngine::deliver(double units, DeliveryKind kind)
+{
+    // checkBolus has made sure the reservoir holds it
+    if (device) device->deliverBolus(units);
+    safetyManager->recordBolus(units);
+    insulinOnBoard.add(units);
+    if (metrics) {
+        metrics->bolusesDelivered.add();
+        metrics->insulinDeliveredMilliUnits.add(static_cast<std::uint64_t>(units * 1000.0 + 0.5));
+    }
+    if (telemetry) publish(TelemetryKind::Delivery, static_cast<std::uint8_t>(kind), cgmModel->getCurrentBg(), units, 0.0);
+}
+
+void PumpEngine::publish(TelemetryKind kind, std::uint8_t detail, double bg, double units, double rate)
+{
+    TelemetryEvent event;
+    event.simMinute = cgmModel->getSimTime().minutes();
+    event.bg = bg;
+    event.units = units;
+    event.rate = rate;
+    event.insulinOnBoard = insulinOnBoard.value();
+    event.pump = telemetryPump;
+    event.kind = kind;
+    event.detail = detail;
+    telemetry->publish(event);
+}
+
+void PumpEngine::saveState(BinaryWriter& out) const
+{
+    out.put<std::uint8_t>(static_cast<std::uint8_t>(controllerKind));
+    std::visit([&out](const auto& p) { p.saveState(out); }, controller);
+    out.put(insulinOnBoard.value());
+    out.put(deliveredBasalRate);
+    out.put(scheduledBasalRate);
+    out.put(extendedRemaining);
+    out.put(extendedRate);
+}
+
+bool PumpEngine::restoreState(BinaryReader& in)
+{
+    std::uint8_t kind = 0;
+    if (!in.get(kind) || kind > static_cast<std::uint8_t>(ControllerKind::Mpc)) return false;
+    setController(static_cast<ControllerKind>(kind));
+    if (!std::visit([&in](auto& p) { return p.restoreState(in); }, controller)) return false;
+
+    double iob = 0.0;
+    if (!in.get(iob) || !in.get(deliveredBasalRate) || !in.get(scheduledBasalRate)
+        || !in.get(extendedRemaining) || !in.get(extendedRate))
+        return false;
+    insulinOnBoard.setValue(iob);
+    return true;
+}
@@ -0,0 +1,168 @@
+#ifndef PUMPENGINE_H
+#define PUMPENGINE_H
+
+#include <string>
+#include "UserProfileManager.h"
+#include "HistoryManager.h"
+#include "BolusSafetyManager.h"
+#include "CarbAbsorption.h"
+#include "CgmModel.h"
+#include "ControlIQ.h"
+#include "InsulinOnBoard.h"
+#include "PumpDevice.h"
+#include "PumpMetrics.h"
+#include "TelemetryFeed.h"
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief PumpEngine ties together the CGM data, safety checks,
+ * history logging, and user inputs (manual bolus). It also
+ * runs the selected Control-IQ policy (see ControlIQ.h) for auto basal
+ * or auto bolus, and tracks net insulin on board.
+ * It is plain C++ so it can run without Qt (headless, benchmarks);
+ * the GUI reaches it through the PumpController adapter.
+ */
+class PumpEngine
+{
+public:
+    PumpEngine(UserProfileManager* profileMgr,
+               HistoryManager* histMgr,
+               BolusSafetyManager* safetyMgr,
+               CgmModel* cgm);
+
+    /**
+     * @brief Longest extended bolus, in hours (as the GUI allows).
+     */
+    static constexpr int maxExtendedHours = 24;
+
+    /**
+     * @brief requestBolus attempts to deliver a manual bolus
+     * (possibly extended), checking safety constraints
+     * and logging events in the history.
+     */
+    bool requestBolus(double totalBolus,
+                      const std::string& notes,
+                      double extendedFrac = 0.0,
+                      int durationHrs = 0);
+
+    /**
+     * @brief onCgmUpdated is called whenever a new BG reading arrives,
+     * logs it, then runs the ControlIQ logic.
+     */
+    void onCgmUpdated(double newBg);
+
+    /**
+     * @brief Active profile settings for the current simulated time,
+     * an O(1) lookup in the snapshot's compiled schedule.
+     */
+    const TherapySettings& getCurrentSettings() const;
+
+    /**
+     * @brief Selects the Control-IQ policy for this run (threshold by default).
+     */
+    void setController(ControllerKind kind);
+    ControllerKind getControllerKind() const { return controllerKind; }
+
+    double getInsulinOnBoard() const { return insulinOnBoard.value(); }
+
+    /**
+     * @brief Units of an extended bolus still to be infused.
+     */
+    double getExtendedRemaining() const { return extendedRemaining; }
+
+    /**
+     * @brief The hardware every delivery draws on (may be null: unlimited
+     * insulin, no battery). Its reservoir also limits boluses.
+     */
+    void setDevice(PumpDevice* d) { device = d; }
+
+    /**
+     * @brief The meals being absorbed, whose carbs on board Control-IQ
+     * sees (may be null: none).
+     */
+    void setCarbs(const CarbAbsorption* c) { carbs = c; }
+
+    /**
+     * @brief Where decisions, deliveries and refusals are counted (may be null).
+     */
+    void setMetrics(PumpMetrics* m) { metrics = m; }
+
+    /**
+     * @brief Where readings, decisions, deliveries and refusals are
+     * published, tagged with pump (may be null).
+     */
+    void setTelemetry(TelemetryFeed* feed, std::uint32_t pump = 0)
+    {
+        telemetry = feed;
+        telemetryPump = pump;
+    }
+
+    /**
+     * @brief Basal rate (U/h) being delivered until the next reading.
+     */
+    double getDeliveredBasalRate() const { return deliveredBasalRate; }
+
+    /**
+     * @brief Checkpoint support: controller choice and state, IOB, the
+     * basal rates of the interval in progress and any extended bolus.
+     */
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    UserProfileManager* userProfileManager;
+    HistoryManager*     historyManager;
+    BolusSafetyManager* safetyManager;
+    CgmModel*           cgmModel;
+    PumpDevice*         device;
+    const CarbAbsorption* carbs;
+    PumpMetrics*        metrics;
+    TelemetryFeed*      telemetry;
+    std::uint32_t       telemetryPump;
+
+    ControllerKind   controllerKind;
+    ControllerPolicy controller;
+    InsulinOnBoard   insulinOnBoard;
+    double deliveredBasalRate;  // U/h since the last reading
+    double scheduledBasalRate;  // U/h the schedule asked for over the same span
+    double extendedRemaining;   // U of an extended bolus not yet infused
+    double extendedRate;        // U/min while extendedRemaining > 0
+
+    /**
+     * @brief runControlIQ asks the policy for a decision on the new
+     * reading and carries it out (suspend, adjust basal, auto-correct).
+     */
+    void runControlIQ(double currentBg);
+
+    /**
+     * @brief accountBasal books the last interval's basal deviation and
+     * extended bolus infusion into IOB.
+     */
+    void accountBasal(double minutes);
+
+    /**
+     * @brief checkBolus runs the safety rules for a dose under the active
+     * profile's limits, with the current BG as an observation.
+     */
+    bool checkBolus(double units, std::string& errorMsg);
+
+    /**
+     * @brief deliverAutoBolus attempts an automatic correction bolus.
+     */
+    void deliverAutoBolus(double units, const std::string& reason);
+
+    /**
+     * @brief deliver records a bolus that passed checkBolus.
+     */
+    void deliver(double units, DeliveryKind kind);
+
+    /**
+     * @brief publish sends one event, stamped with the sim minute and IOB,
+     * to the telemetry feed if there is one.
+     */
+    void publish(TelemetryKind kind, std::uint8_t detail, double bg, double units, double rate);
+};
+
+#endif // PUMPENGINE_H
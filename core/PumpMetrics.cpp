@@ -0,0 +1,41 @@
+#include "PumpMetrics.h"
+
+namespace {
+
+const char* const actionLabels[PumpMetrics::actionCount] = {
+    "none", "suspend", "adjust_basal", "auto_bolus"
+};
+
+const char* const blockReasonLabels[PumpMetrics::blockReasonCount] = {
+    "", "non_positive", "exceeds_max_single", "exceeds_daily_limit",
+    "cooldown", "exceeds_iob_cap", "bg_lockout", "insufficient_reservoir"
+};
+
+static_assert(static_cast<int>(ControlAction::AutoBolus) + 1 == PumpMetrics::actionCount,
+              "actionLabels out of step with ControlAction");
+static_assert(static_cast<int>(BolusBlockReason::InsufficientReservoir) + 1 == PumpMetrics::blockReasonCount,
+              "blockReasonLabels out of step with BolusBlockReason");
+
+} // namespace
+
+PumpMetrics::PumpMetrics()
+    : ticks(registry.counter("pump_ticks_total", "CGM ticks processed."))
+    , decisions {}
+    , bolusesBlocked {}
+    , bolusesDelivered(registry.counter("pump_boluses_delivered_total", "Boluses delivered, manual and automatic."))
+    , insulinDeliveredMilliUnits(registry.counter("pump_bolus_insulin_milliunits_total", "Bolus insulin delivered, in milli-units."))
+    , historyRecords(registry.gauge("pump_history_records", "Records in the history log."))
+    , historyBytes(registry.gauge("pump_history_bytes", "Approximate memory held by the history log."))
+    , bg(registry.gauge("pump_bg_mmol_per_litre", "Latest CGM reading."))
+    , tickLatency(registry.histogram("pump_tick_latency_seconds", "Wall time from CGM tick to Control-IQ decision."))
+{
+    for (int i = 0; i < actionCount; ++i) {
+        decisions[i] = &registry.counter("pump_controliq_decisions_total", "Control-IQ decisions by outcome.",
+                                         std::string("outcome=\"") + actionLabels[i] + "\"");
+    }
+    // Slot 0 (None) is never counted and stays null, keeping the array indexable by reason
+    for (int i = 1; i < blockReasonCount; ++i) {
+        bolusesBlocked[i] = &registry.counter("pump_boluses_blocked_total", "Bolus requests refused, by reason.",
+                                              std::string("reason=\"") + blockReasonLabels[i] + "\"");
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef PUMPMETRICS_H
+#define PUMPMETRICS_H
+
+#include <array>
+#include "ControllerPolicy.h"
+#include "Metrics.h"
+#include "SafetyRules.h"
+
+/**
+ * @brief The metrics one simulated pump reports, registered in its own
+ * MetricsRegistry. PumpSimulation owns it and hands a pointer to the
+ * engine; the members are the hot-path handles, so an update is a
+ * direct relaxed atomic op with no name lookup.
+ */
+struct PumpMetrics {
+    static constexpr int actionCount = 4;       // ControlAction values
+    static constexpr int blockReasonCount = 8;  // BolusBlockReason values
+
+    PumpMetrics();
+
+    PumpMetrics(const PumpMetrics&) = delete;
+    PumpMetrics& operator=(const PumpMetrics&) = delete;
+
+    MetricsRegistry registry;
+
+    Counter& ticks;
+    std::array<Counter*, actionCount> decisions;
+    std::array<Counter*, blockReasonCount> bolusesBlocked;
+    Counter& bolusesDelivered;
+    Counter& insulinDeliveredMilliUnits;
+    Gauge& historyRecords;
+    Gauge& historyBytes;
+    Gauge& bg;
+    LatencyHistogram& tickLatency;
+
+    Counter& decision(ControlAction action) { return *decisions[static_cast<int>(action)]; }
+    Counter& blocked(BolusBlockReason reason) { return *bolusesBlocked[static_cast<int>(reason)]; }
+};
+
+#endif // PUMPMETRICS_H
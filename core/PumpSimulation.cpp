@@ -0,0 +1,201 @@
+#include "PumpSimulation.h"
+#include "BinaryIo.h"
+#include "Trace.h"
+#include <chrono>
+#include <cstdio>
+
+PumpSimulation::PumpSimulation(unsigned seed)
+    : safetyManager(&simClock)
+    , cgmModel(&simClock, seed)
+    , device(&simClock, &historyManager)
+    , pumpEngine(&profileManager, &historyManager, &safetyManager, &cgmModel)
+    , warningMonitor(&historyManager, &cgmModel)
+{
+    pumpEngine.setDevice(&device);
+    pumpEngine.setMetrics(&metrics);
+    pumpEngine.setCarbs(&carbs);
+}
+
+double PumpSimulation::step()
+{
+    PUMP_TRACE_SCOPE("sim", "PumpSimulation::step");
+    auto started = std::chrono::steady_clock::now();
+    scenarioRunner.run(*this);
+    double absorbed = carbs.advance(CgmModel::minutesPerTick);
+    if (physiology) {
+        cgmModel.applyEffect(glucoseResponse.advance(CgmModel::minutesPerTick,
+                                                     pumpEngine.getInsulinOnBoard(), absorbed,
+                                                     pumpEngine.getCurrentSettings()));
+    }
+    double bg = cgmModel.tick();
+    pumpEngine.onCgmUpdated(bg);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    metrics.tickLatency.record(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    metrics.ticks.add();
+    metrics.bg.set(bg);
+    metrics.historyRecords.set(static_cast<double>(historyManager.getRecords().size()));
+    metrics.historyBytes.set(static_cast<double>(historyManager.getMemoryBytes()));
+    return bg;
+}
+
+void PumpSimulation::setScenario(std::shared_ptr<const Scenario> scenario)
+{
+    scenarioRunner = ScenarioRunner(std::move(scenario));
+    if (scenarioRunner.hasScenario()) physiology = true;
+}
+
+namespace {
+
+const char checkpointMagic[4] = { 'T', 'P', 'C', 'K' };
+// 2: extended bolus in progress; 3: physiology, scenario, sensor bias;
+// 4: pump device (fractional battery) in place of the warning monitor;
+// 5: history times as integer minutes instead of text; 6: meals being absorbed
+const std::uint32_t checkpointFormatVersion = 6;
+
+} // namespace
+
+void PumpSimulation::saveCoreState(BinaryWriter& out) const
+{
+    out.put<std::int64_t>(simClock.now().minutes());
+    profileManager.saveState(out);
+    safetyManager.saveState(out);
+    device.saveState(out);
+    pumpEngine.saveState(out);
+    out.put<std::uint8_t>(physiology ? 1 : 0);
+    glucoseResponse.saveState(out);
+    carbs.saveState(out);
+}
+
+bool PumpSimulation::restoreCoreState(BinaryReader& in)
+{
+    std::int64_t minutes = 0;
+    if (!in.get(minutes)) return false;
+    simClock.set(SimTime::fromMinutes(minutes));
+    std::uint8_t physiologyOn = 0;
+    if (!profileManager.restoreState(in) || !safetyManager.restoreState(in)
+        || !device.restoreState(in) || !pumpEngine.restoreState(in)
+        || !in.get(physiologyOn) || !glucoseResponse.restoreState(in)
+        || !carbs.restoreState(in))
+        return false;
+    physiology = physiologyOn != 0;
+    return true;
+}
+
+/**
+ * @brief adoptState copies other's state into this pump: the history by
+ * sharing pages, the CGM model and scenario position by assignment (the
+ * script itself is shared) and the rest through an in-memory image of a
+ * few hundred bytes.
+ */
+void PumpSimulation::adoptState(const PumpSimulation& other)
+{
+    std::string image;
+    BinaryWriter out(image);
+    other.saveCoreState(out);
+    BinaryReader in(image.data(), image.size());
+    restoreCoreState(in);
+    cgmModel.copyStateFrom(other.cgmModel);
+    scenarioRunner = other.scenarioRunner;
+    historyManager = other.historyManager;
+}
+
+std::string PumpSimulation::checkpoint() const
+{
+    PUMP_TRACE_SCOPE("sim", "PumpSimulation::checkpoint");
+    std::string image;
+    image.reserve(4096 + historyManager.size() * 48);
+    BinaryWriter out(image);
+    out.putBytes(checkpointMagic, 4);
+    out.put(checkpointFormatVersion);
+    saveCoreState(out);
+    scenarioRunner.saveState(out);
+    cgmModel.saveState(out);
+    historyManager.saveState(out);
+    return image;
+}
+
+bool PumpSimulation::restore(const std::string& image, std::string& error)
+{
+    PUMP_TRACE_SCOPE("sim", "PumpSimulation::restore");
+    BinaryReader in(image.data(), image.size());
+    std::string magic;
+    std::uint32_t version = 0;
+    if (!in.getBytes(magic, 4) || magic.compare(0, 4, checkpointMagic, 4) != 0) {
+        error = "Not a pump checkpoint";
+        return false;
+    }
+    if (!in.get(version) || version != checkpointFormatVersion) {
+        error = "Unsupported checkpoint version " + std::to_string(version);
+        return false;
+    }
+
+    // Decode into a scratch pump first so a bad image changes nothing here
+    PumpSimulation scratch(0);
+    if (!scratch.restoreCoreState(in) || !scratch.scenarioRunner.restoreState(in)
+        || !scratch.cgmModel.restoreState(in)
+        || !scratch.historyManager.restoreState(in)) {
+        error = "Checkpoint is truncated or corrupt";
+        return false;
+    }
+    if (!in.atEnd()) {
+        error = "Checkpoint has trailing data";
+        return false;
+    }
+    adoptState(scratch);
+    return true;
+}
+
+bool PumpSimulation::saveCheckpoint(const std::string& path, std::string& error) const
+{
+    std::string image = checkpoint();
+    std::string tmpPath = path + ".tmp";
+    std::FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) {
+        error = "Cannot open " + tmpPath + " for writing";
+        return false;
+    }
+    bool ok = std::fwrite(image.data(), 1, image.size(), f) == image.size();
+    if (std::fclose(f) != 0) ok = false;
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        error = "Cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+bool PumpSimulation::loadCheckpoint(const std::string& path, std::string& error)
+{
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    std::string image;
+    char buf[65536];
+    std::size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) {
+        image.append(buf, n);
+    }
+    bool readOk = std::ferror(f) == 0;
+    std::fclose(f);
+    if (!readOk) {
+        error = "Cannot read " + path;
+        return false;
+    }
+    if (!restore(image, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<PumpSimulation> PumpSimulation::fork() const
+{
+    PUMP_TRACE_SCOPE("sim", "PumpSimulation::fork");
+    std::unique_ptr<PumpSimulation> child(new PumpSimulation(0));
+    child->adoptState(*this);
+    return child;
+}
@@ -0,0 +1,131 @@
+#ifndef PUMPSIMULATION_H
+#define PUMPSIMULATION_H
+
+#include <memory>
+#include <random>
+#include <string>
+#include "SimClock.h"
+#include "UserProfileManager.h"
+#include "HistoryManager.h"
+#include "BolusSafetyManager.h"
+#include "CarbAbsorption.h"
+#include "CgmModel.h"
+#include "GlucoseResponse.h"
+#include "PumpDevice.h"
+#include "PumpEngine.h"
+#include "PumpMetrics.h"
+#include "Scenario.h"
+#include "WarningMonitor.h"
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief PumpSimulation owns one complete simulated pump: the sim clock, profiles,
+ * history, safety limits, the CGM model, the pump hardware (reservoir and
+ * battery), the pump engine and the warning monitor. step() runs one CGM tick through Control-IQ with
+ * plain function calls, so it can be driven by a QTimer in the GUI or
+ * by a tight loop in headless runs. Each step also updates the pump's
+ * metrics (see PumpMetrics).
+ *
+ * Meals (from a Scenario or the bolus screen) go into CarbAbsorption,
+ * which every step advances; its carbs on board reach Control-IQ and
+ * the bolus calculator either way. With physiology on, each step also
+ * applies the GlucoseResponse to insulin on board, the carbs absorbed
+ * and exercise; a Scenario, if set, runs its due steps before that.
+ * Without either the CGM is the bare random walk.
+ *
+ * The whole pump state can be checkpointed to a compact binary image and
+ * restored, or forked in memory: a fork shares the parent's history
+ * pages copy-on-write (see HistoryManager) and copies the rest, which is
+ * a few kilobytes, so many branches can start from one warmed-up patient
+ * without replaying its past. Checkpoints and forks carry the active
+ * profile, not the profile library, and not the metrics.
+ */
+class PumpSimulation
+{
+public:
+    explicit PumpSimulation(unsigned seed = std::random_device{}());
+
+    PumpSimulation(const PumpSimulation&) = delete;
+    PumpSimulation& operator=(const PumpSimulation&) = delete;
+
+    /**
+     * @brief step advances one CGM tick (5 simulated minutes) and
+     * runs the pump logic on the new reading.
+     * @return the new BG reading
+     */
+    double step();
+
+    SimClock& getSimClock() { return simClock; }
+    UserProfileManager& getProfileManager() { return profileManager; }
+    HistoryManager& getHistoryManager() { return historyManager; }
+    BolusSafetyManager& getSafetyManager() { return safetyManager; }
+    CgmModel& getCgmModel() { return cgmModel; }
+    PumpDevice& getDevice() { return device; }
+    PumpEngine& getPumpEngine() { return pumpEngine; }
+    WarningMonitor& getWarningMonitor() { return warningMonitor; }
+    PumpMetrics& getMetrics() { return metrics; }
+    GlucoseResponse& getGlucoseResponse() { return glucoseResponse; }
+    CarbAbsorption& getCarbs() { return carbs; }
+
+    /**
+     * @brief setPhysiology turns the insulin, carb and exercise response on or off.
+     */
+    void setPhysiology(bool enabled) { physiology = enabled; }
+    bool hasPhysiology() const { return physiology; }
+
+    /**
+     * @brief setScenario starts scenario from its first step and turns
+     * physiology on; null removes the script.
+     */
+    void setScenario(std::shared_ptr<const Scenario> scenario);
+    const ScenarioRunner& getScenarioRunner() const { return scenarioRunner; }
+
+    /**
+     * @brief checkpoint encodes the full pump state.
+     * Format: "TPCK", u32 version, then clock, active profile, safety
+     * manager, pump device, pump engine, physiology, carbs, scenario,
+     * CGM model and history.
+     */
+    std::string checkpoint() const;
+
+    /**
+     * @brief restore replaces this pump's state with a checkpoint's.
+     * The image is decoded completely before anything is replaced, so
+     * on failure the simulation is unchanged and error says why.
+     */
+    bool restore(const std::string& image, std::string& error);
+
+    bool saveCheckpoint(const std::string& path, std::string& error) const;
+    bool loadCheckpoint(const std::string& path, std::string& error);
+
+    /**
+     * @brief fork returns an independent simulation in the same state.
+     * It continues with the same CGM noise unless reseeded
+     * (getCgmModel().reseed()).
+     */
+    std::unique_ptr<PumpSimulation> fork() const;
+
+private:
+    PumpMetrics        metrics;
+    SimClock           simClock;
+    UserProfileManager profileManager;
+    HistoryManager     historyManager;
+    BolusSafetyManager safetyManager;
+    CgmModel           cgmModel;
+    PumpDevice         device;
+    PumpEngine         pumpEngine;
+    WarningMonitor     warningMonitor;
+    GlucoseResponse    glucoseResponse;
+    CarbAbsorption     carbs;
+    ScenarioRunner     scenarioRunner;
+    bool               physiology = false;
+
+    // Everything but the CGM model, history and scenario, which forks copy directly
+    void saveCoreState(BinaryWriter& out) const;
+    bool restoreCoreState(BinaryReader& in);
+    void adoptState(const PumpSimulation& other);
+};
+
+#endif // PUMPSIMULATION_H
@@ -0,0 +1,138 @@
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+QuantileSketch::QuantileSketch(int k)
+    : k(std::max(k, minLevelCapacity)), rng(0x9e3779b9u)
+{
+    grow();
+}
+
+int QuantileSketch::capacity(int level) const
+{
+    const int depth = static_cast<int>(levels.size()) - 1 - level;
+    const int cap = static_cast<int>(std::ceil(k * std::pow(2.0 / 3.0, depth)));
+    return std::max(cap, minLevelCapacity);
+}
+
+void QuantileSketch::grow()
+{
+    levels.emplace_back();
+    capacityTotal = 0;
+    for (int h = 0; h < static_cast<int>(levels.size()); ++h) {
+        capacityTotal += static_cast<std::size_t>(capacity(h));
+    }
+}
+
+/**
+ * @brief compress halves the lowest full level. Pairs of neighbours in
+ * sorted order are replaced by one of them at double weight; with an odd
+ * count the largest value stays behind, so weight is never lost.
+ */
+void QuantileSketch::compress()
+{
+    for (int h = 0; h < static_cast<int>(levels.size()); ++h) {
+        if (levels[h].size() < static_cast<std::size_t>(capacity(h))) continue;
+        if (h + 1 == static_cast<int>(levels.size())) grow();
+
+        std::vector<float>& level = levels[h];
+        std::vector<float>& up = levels[h + 1];
+        std::sort(level.begin(), level.end());
+        const std::size_t even = level.size() & ~static_cast<std::size_t>(1);
+
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        for (std::size_t i = rng & 1u; i < even; i += 2) {
+            up.push_back(level[i]);
+        }
+        level.erase(level.begin(), level.begin() + static_cast<std::ptrdiff_t>(even));
+        retainedCount -= even / 2;
+        return;
+    }
+}
+
+void QuantileSketch::add(float value)
+{
+    if (std::isnan(value)) return;
+    if (n == 0) {
+        minValue = maxValue = value;
+    } else {
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+    ++n;
+    levels[0].push_back(value);
+    if (++retainedCount >= capacityTotal) compress();
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    if (other.n == 0) return;
+    if (n == 0) {
+        minValue = other.minValue;
+        maxValue = other.maxValue;
+    } else {
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+    while (levels.size() < other.levels.size()) grow();
+    for (std::size_t h = 0; h < other.levels.size(); ++h) {
+        levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+    }
+    n += other.n;
+    retainedCount += other.retainedCount;
+    while (retainedCount >= capacityTotal) compress();
+}
+
+void QuantileSketch::clear()
+{
+    levels.clear();
+    n = 0;
+    retainedCount = 0;
+    minValue = maxValue = 0.0f;
+    grow();
+}
+
+double QuantileSketch::quantile(double q) const
+{
+    double out = 0.0;
+    quantiles(&q, 1, &out);
+    return out;
+}
+
+void QuantileSketch::quantiles(const double* qs, int count, double* out) const
+{
+    if (n == 0) {
+        std::fill(out, out + count, 0.0);
+        return;
+    }
+
+    std::vector<std::pair<float, std::uint64_t>> weighted;
+    weighted.reserve(retainedCount);
+    for (std::size_t h = 0; h < levels.size(); ++h) {
+        for (float v : levels[h]) weighted.emplace_back(v, std::uint64_t(1) << h);
+    }
+    std::sort(weighted.begin(), weighted.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::size_t i = 0;
+    std::uint64_t below = weighted.empty() ? 0 : weighted[0].second;
+    for (int j = 0; j < count; ++j) {
+        const double q = qs[j];
+        if (q <= 0.0) {
+            out[j] = minValue;
+            continue;
+        }
+        if (q >= 1.0) {
+            out[j] = maxValue;
+            continue;
+        }
+        const double rank = std::ceil(q * static_cast<double>(n));
+        while (static_cast<double>(below) < rank && i + 1 < weighted.size()) {
+            below += weighted[++i].second;
+        }
+        out[j] = weighted[i].first;
+    }
+}
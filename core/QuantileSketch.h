@@ -0,0 +1,77 @@
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief QuantileSketch is a KLL sketch: approximate quantiles of a
+ * stream in bounded memory, mergeable with other sketches.
+ *
+ * Values are kept in levels; a value on level h stands for 2^h of the
+ * values added. When the sketch is full, the lowest level over its
+ * capacity is sorted and every other value (starting at a random one of
+ * the first two) moves up a level, halving that level. Capacities shrink
+ * by 2/3 per level down from k at the top, so the sketch holds under 3k
+ * values however many were added, and a quantile's rank is off by about
+ * 1.7/k of the count (1% at the default k). Until the first compaction
+ * every value is kept and quantiles are exact. merge() appends the other
+ * sketch's levels and compacts the same way, so sketches built
+ * separately (per patient, per day) combine into one with the same
+ * error bound. The random choice comes from a per-sketch generator with
+ * a fixed seed, so the same values give the same sketch.
+ */
+class QuantileSketch
+{
+public:
+    static constexpr int defaultK = 200;
+    static constexpr int minLevelCapacity = 8;
+
+    explicit QuantileSketch(int k = defaultK);
+
+    void add(float value);
+    void merge(const QuantileSketch& other);
+    void clear();
+
+    std::uint64_t count() const { return n; }
+    bool empty() const { return n == 0; }
+    int getK() const { return k; }
+
+    /**
+     * @brief Values held now, at most about 3k.
+     */
+    std::size_t retained() const { return retainedCount; }
+
+    float min() const { return minValue; }
+    float max() const { return maxValue; }
+
+    /**
+     * @brief Value at quantile q (0..1) by nearest rank: the smallest
+     * value with at least q of the count at or below it. q 0 and 1 give
+     * the exact min and max; an empty sketch gives 0.
+     */
+    double quantile(double q) const;
+
+    /**
+     * @brief quantiles answers several quantiles (ascending) with one
+     * sort of the retained values.
+     */
+    void quantiles(const double* qs, int count, double* out) const;
+
+private:
+    int k;
+    std::uint64_t n = 0;
+    std::uint32_t rng;
+    float minValue = 0.0f;
+    float maxValue = 0.0f;
+    std::vector<std::vector<float>> levels;   // levels[h] weighs 2^h
+    std::size_t retainedCount = 0;
+    std::size_t capacityTotal = 0;
+
+    int capacity(int level) const;
+    void grow();
+    void compress();
+};
+
+#endif // QUANTILESKETCH_H
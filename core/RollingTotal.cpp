@@ -0,0 +1,83 @@
+#include "RollingTotal.h"
+#include "BinaryIo.h"
+#include <algorithm>
+#include <cmath>
+
+RollingTotal::RollingTotal(int bucketMinutes, int bucketCount)
+    : bucketMinutes(bucketMinutes)
+    , buckets(bucketCount, 0)
+    , runningSum(0)
+    , headBucket(0)
+{
+}
+
+void RollingTotal::add(SimTime now, double amount)
+{
+    advanceTo(now);
+    std::int64_t milli = std::llround(amount * 1000.0);
+    buckets[headBucket % buckets.size()] += milli;
+    runningSum += milli;
+}
+
+double RollingTotal::total(SimTime now)
+{
+    advanceTo(now);
+    return runningSum / 1000.0;
+}
+
+void RollingTotal::clear()
+{
+    std::fill(buckets.begin(), buckets.end(), 0);
+    runningSum = 0;
+}
+
+void RollingTotal::saveState(BinaryWriter& out) const
+{
+    out.put<std::int32_t>(bucketMinutes);
+    out.put<std::uint32_t>(static_cast<std::uint32_t>(buckets.size()));
+    out.put<std::int64_t>(headBucket);
+    for (std::int64_t b : buckets) {
+        out.put(b);
+    }
+}
+
+bool RollingTotal::restoreState(BinaryReader& in)
+{
+    std::int32_t savedBucketMinutes = 0;
+    std::uint32_t savedCount = 0;
+    std::int64_t savedHead = 0;
+    if (!in.get(savedBucketMinutes) || !in.get(savedCount) || !in.get(savedHead)
+        || savedBucketMinutes != bucketMinutes || savedCount != buckets.size())
+        return false;
+
+    runningSum = 0;
+    for (std::int64_t& b : buckets) {
+        if (!in.get(b)) return false;
+        runningSum += b;
+    }
+    headBucket = savedHead;
+    return true;
+}
+
+/**
+ * @brief advanceTo expires every bucket that left the window since the
+ * last call. Time never runs backwards in the simulation; a stale
+ * timestamp is treated as "now".
+ */
+void RollingTotal::advanceTo(SimTime now)
+{
+    long long target = now.minutes() / bucketMinutes;
+    if (target <= headBucket) return;
+
+    long long count = static_cast<long long>(buckets.size());
+    if (target - headBucket >= count) {
+        clear();
+    } else {
+        for (long long b = headBucket + 1; b <= target; ++b) {
+            std::int64_t& slot = buckets[b % count];
+            runningSum -= slot;
+            slot = 0;
+        }
+    }
+    headBucket = target;
+}
@@ -0,0 +1,48 @@
+#ifndef ROLLINGTOTAL_H
+#define ROLLINGTOTAL_H
+
+#include <cstdint>
+#include <vector>
+#include "SimTime.h"
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief RollingTotal sums amounts over a sliding time window using a
+ * ring of fixed-width buckets (e.g. 288 x 5 min = 24h).
+ *
+ * Amounts are kept as integer milli-units so the running sum never drifts.
+ * add() and total() are O(1) amortised: advancing the window only clears
+ * the buckets that fell out since the last call, and a jump longer than
+ * the whole window clears the ring once.
+ * Granularity is one bucket: an entry expires between
+ * (window - bucketMinutes) and window minutes after it was added.
+ */
+class RollingTotal
+{
+public:
+    RollingTotal(int bucketMinutes, int bucketCount);
+
+    void add(SimTime now, double amount);
+    double total(SimTime now);
+
+    void clear();
+
+    /**
+     * @brief Checkpoint support. restoreState fails if the saved ring has
+     * a different shape.
+     */
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    int bucketMinutes;
+    std::vector<std::int64_t> buckets;   // milli-units per bucket
+    std::int64_t runningSum;
+    long long headBucket;                // absolute index of the newest bucket
+
+    void advanceTo(SimTime now);
+};
+
+#endif // ROLLINGTOTAL_H
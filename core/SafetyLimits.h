@@ -0,0 +1,26 @@
+#ifndef SAFETYLIMITS_H
+#define SAFETYLIMITS_H
+
+/**
+ * @brief SafetyLimits are the per-profile numbers the bolus safety rules
+ * are checked against (see SafetyRules.h).
+ */
+struct SafetyLimits {
+    double maxSingleBolus = 10.0;    // U per bolus
+    double maxDailyBolus  = 30.0;    // U per rolling 24h
+    double cooldownMinutes = 10.0;   // minimum gap between boluses
+    double maxInsulinOnBoard = 15.0; // U, IOB after the bolus
+    double bgLockout = 3.9;          // mmol/L, no bolus below this BG
+
+    bool operator==(const SafetyLimits& o) const
+    {
+        return maxSingleBolus == o.maxSingleBolus
+            && maxDailyBolus == o.maxDailyBolus
+            && cooldownMinutes == o.cooldownMinutes
+            && maxInsulinOnBoard == o.maxInsulinOnBoard
+            && bgLockout == o.bgLockout;
+    }
+    bool operator!=(const SafetyLimits& o) const { return !(*this == o); }
+};
+
+#endif // SAFETYLIMITS_H
@@ -0,0 +1,113 @@
+#include "SafetyRules.h"
+#include "StringUtil.h"
+#include <cmath>
+
+const SafetyRule defaultSafetyRules[] = {
+    { SafetyField::Amount,           Comparison::NotGreaterThan, SafetyLimit::Zero,              BolusBlockReason::NonPositive },
+    { SafetyField::Amount,           Comparison::GreaterThan,    SafetyLimit::MaxSingleBolus,    BolusBlockReason::ExceedsMaxSingle },
+    { SafetyField::DailyTotalAfter,  Comparison::GreaterThan,    SafetyLimit::MaxDailyBolus,     BolusBlockReason::ExceedsDailyLimit },
+    { SafetyField::MinutesSinceLast, Comparison::LessThan,       SafetyLimit::CooldownMinutes,   BolusBlockReason::Cooldown },
+    { SafetyField::IobAfter,         Comparison::GreaterThan,    SafetyLimit::MaxInsulinOnBoard, BolusBlockReason::ExceedsIobCap },
+    { SafetyField::Bg,               Comparison::LessThan,       SafetyLimit::BgLockout,         BolusBlockReason::BgLockout },
+    { SafetyField::ReservoirAfter,   Comparison::LessThan,       SafetyLimit::Zero,              BolusBlockReason::InsufficientReservoir },
+};
+const std::size_t defaultSafetyRuleCount = sizeof(defaultSafetyRules) / sizeof(defaultSafetyRules[0]);
+
+namespace {
+
+double resolveLimit(SafetyLimit limit, const SafetyLimits& limits)
+{
+    switch (limit) {
+    case SafetyLimit::MaxSingleBolus:    return limits.maxSingleBolus;
+    case SafetyLimit::MaxDailyBolus:     return limits.maxDailyBolus;
+    case SafetyLimit::CooldownMinutes:   return limits.cooldownMinutes;
+    case SafetyLimit::MaxInsulinOnBoard: return limits.maxInsulinOnBoard;
+    case SafetyLimit::BgLockout:         return limits.bgLockout;
+    default:                             return 0.0;
+    }
+}
+
+} // namespace
+
+CompiledSafetyRules::CompiledSafetyRules()
+    : CompiledSafetyRules(defaultSafetyRules, defaultSafetyRuleCount, SafetyLimits())
+{
+}
+
+CompiledSafetyRules::CompiledSafetyRules(const SafetyRule* table, std::size_t count,
+                                         const SafetyLimits& limits)
+    : rules()
+    , ruleCount(count < maxRules ? count : maxRules)
+{
+    for (std::size_t i = 0; i < ruleCount; ++i) {
+        rules[i] = { table[i].field, table[i].cmp, table[i].reason,
+                     resolveLimit(table[i].limit, limits) };
+    }
+}
+
+/**
+ * @brief evaluate fills the field vector once, then walks the rules.
+ * Comparisons against NaN are false, so unknown inputs pass; only
+ * NotGreaterThan (the amount rule) trips on NaN.
+ */
+BolusBlockReason CompiledSafetyRules::evaluate(const BolusCandidate& c) const
+{
+    double fields[static_cast<std::size_t>(SafetyField::Count)];
+    fields[static_cast<std::size_t>(SafetyField::Amount)]           = c.amount;
+    fields[static_cast<std::size_t>(SafetyField::DailyTotalAfter)]  = c.rollingDailyTotal + c.amount;
+    fields[static_cast<std::size_t>(SafetyField::MinutesSinceLast)] = c.minutesSinceLastBolus;
+    fields[static_cast<std::size_t>(SafetyField::IobAfter)]         = c.insulinOnBoard + c.amount;
+    fields[static_cast<std::size_t>(SafetyField::Bg)]               = c.bg;
+    fields[static_cast<std::size_t>(SafetyField::ReservoirAfter)]   = c.reservoir - c.amount;
+
+    for (std::size_t i = 0; i < ruleCount; ++i) {
+        const CompiledRule& r = rules[i];
+        double v = fields[static_cast<std::size_t>(r.field)];
+        bool tripped = false;
+        switch (r.cmp) {
+        case Comparison::LessThan:       tripped = v <  r.threshold; break;
+        case Comparison::LessOrEqual:    tripped = v <= r.threshold; break;
+        case Comparison::GreaterThan:    tripped = v >  r.threshold; break;
+        case Comparison::NotGreaterThan: tripped = !(v > r.threshold); break;
+        }
+        if (tripped) return r.reason;
+    }
+    return BolusBlockReason::None;
+}
+
+void CompiledSafetyRules::evaluateBatch(const CompiledSafetyRules* ruleSets,
+                                        const BolusCandidate* candidates,
+                                        std::size_t n,
+                                        BolusBlockReason* out)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = ruleSets[candidates[i].ruleSet].evaluate(candidates[i]);
+    }
+}
+
+std::string describeBlockReason(BolusBlockReason reason,
+                                const SafetyLimits& limits,
+                                const BolusCandidate& candidate)
+{
+    switch (reason) {
+    case BolusBlockReason::None:
+        return std::string();
+    case BolusBlockReason::NonPositive:
+        return "Bolus must be > 0.";
+    case BolusBlockReason::ExceedsMaxSingle:
+        return "Exceeds max single bolus of " + formatFixed(limits.maxSingleBolus, 0) + "U.";
+    case BolusBlockReason::ExceedsDailyLimit:
+        return "Exceeds daily bolus limit of " + formatFixed(limits.maxDailyBolus, 0) + "U.";
+    case BolusBlockReason::Cooldown: {
+        double remain = std::ceil(limits.cooldownMinutes - candidate.minutesSinceLastBolus);
+        return "Wait " + formatFixed(remain, 0) + " more minute(s) before another bolus.";
+    }
+    case BolusBlockReason::ExceedsIobCap:
+        return "Insulin on board would exceed " + formatFixed(limits.maxInsulinOnBoard, 1) + "U.";
+    case BolusBlockReason::BgLockout:
+        return "BG below " + formatFixed(limits.bgLockout, 1) + " mmol/L, bolus locked out.";
+    case BolusBlockReason::InsufficientReservoir:
+        return "Not enough insulin in the reservoir.";
+    }
+    return std::string();
+}
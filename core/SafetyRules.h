@@ -0,0 +1,130 @@
+#ifndef SAFETYRULES_H
+#define SAFETYRULES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include "SafetyLimits.h"
+
+/**
+ * @brief Why a bolus was refused. None means it may be delivered.
+ */
+enum class BolusBlockReason : std::uint8_t {
+    None,
+    NonPositive,
+    ExceedsMaxSingle,
+    ExceedsDailyLimit,
+    Cooldown,
+    ExceedsIobCap,
+    BgLockout,
+    InsufficientReservoir
+};
+
+/**
+ * @brief Everything the rules need to judge one candidate dose.
+ * Observations the caller does not have are left as NaN; a NaN field
+ * never trips a rule, except the amount, which must be a number > 0.
+ */
+struct BolusCandidate {
+    double amount = 0.0;
+    double rollingDailyTotal = 0.0;
+    double minutesSinceLastBolus = std::numeric_limits<double>::infinity();
+    double insulinOnBoard = std::numeric_limits<double>::quiet_NaN();
+    double bg = std::numeric_limits<double>::quiet_NaN();
+    double reservoir = std::numeric_limits<double>::quiet_NaN();
+    std::uint32_t ruleSet = 0;   // index into the rule sets given to evaluateBatch
+};
+
+/**
+ * @brief Quantities a rule can test. Derived fields (..After) are the
+ * value once the candidate dose is delivered.
+ */
+enum class SafetyField : std::uint8_t {
+    Amount,
+    DailyTotalAfter,
+    MinutesSinceLast,
+    IobAfter,
+    Bg,
+    ReservoirAfter,
+    Count
+};
+
+enum class SafetyLimit : std::uint8_t {
+    Zero,
+    MaxSingleBolus,
+    MaxDailyBolus,
+    CooldownMinutes,
+    MaxInsulinOnBoard,
+    BgLockout
+};
+
+/**
+ * @brief How a rule compares its field with its limit. All but
+ * NotGreaterThan are false for NaN, so an unknown value passes;
+ * NotGreaterThan trips on NaN, for values that must be known.
+ */
+enum class Comparison : std::uint8_t { LessThan, LessOrEqual, GreaterThan, NotGreaterThan };
+
+/**
+ * @brief One declarative rule: "block with <reason> if <field> <cmp> <limit>".
+ */
+struct SafetyRule {
+    SafetyField field;
+    Comparison cmp;
+    SafetyLimit limit;
+    BolusBlockReason reason;
+};
+
+/**
+ * @brief The pump's rule table, checked in order; the first rule that
+ * trips gives the reason.
+ */
+extern const SafetyRule defaultSafetyRules[];
+extern const std::size_t defaultSafetyRuleCount;
+
+/**
+ * @brief CompiledSafetyRules is a rule table with every limit resolved
+ * to a number for one profile. Evaluation is a straight loop over a
+ * fixed array and never allocates.
+ */
+class CompiledSafetyRules
+{
+public:
+    static constexpr std::size_t maxRules = 16;
+
+    CompiledSafetyRules();
+    CompiledSafetyRules(const SafetyRule* table, std::size_t count, const SafetyLimits& limits);
+
+    BolusBlockReason evaluate(const BolusCandidate& c) const;
+
+    /**
+     * @brief evaluateBatch checks n candidates in one pass. Each candidate
+     * selects its rule set (e.g. its patient's profile) via ruleSet.
+     */
+    static void evaluateBatch(const CompiledSafetyRules* ruleSets,
+                              const BolusCandidate* candidates,
+                              std::size_t n,
+                              BolusBlockReason* out);
+
+private:
+    struct CompiledRule {
+        SafetyField field;
+        Comparison cmp;
+        BolusBlockReason reason;
+        double threshold;
+    };
+
+    std::array<CompiledRule, maxRules> rules;
+    std::size_t ruleCount;
+};
+
+/**
+ * @brief Human-readable explanation of a refusal, for the UI and history.
+ */
+std::string describeBlockReason(BolusBlockReason reason,
+                                const SafetyLimits& limits,
+                                const BolusCandidate& candidate);
+
+#endif // SAFETYRULES_H
@@ -0,0 +1,331 @@
+#include "Scenario.h"
+#include "BinaryIo.h"
+#include "BolusCalculator.h"
+#include "PumpSimulation.h"
+#include "StringUtil.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+bool parseNumber(const std::string& token, double& out, const char* suffix = "")
+{
+    std::string s = token;
+    std::size_t n = std::char_traits<char>::length(suffix);
+    if (n > 0 && s.size() > n && s.compare(s.size() - n, n, suffix) == 0) {
+        s.erase(s.size() - n);
+    }
+    if (s.empty()) return false;
+    char* end = nullptr;
+    out = std::strtod(s.c_str(), &end);
+    return *end == '\0';
+}
+
+bool parseTimeOfDay(const std::string& token, double& minuteOfDay)
+{
+    int h = 0, m = 0;
+    char colon = 0, extra = 0;
+    if (std::sscanf(token.c_str(), "%d%c%d%c", &h, &colon, &m, &extra) != 3 || colon != ':'
+        || h < 0 || h > 23 || m < 0 || m > 59)
+        return false;
+    minuteOfDay = h * 60 + m;
+    return true;
+}
+
+/**
+ * @brief parseExtended reads an optional "extended 40% 3h" tail. The
+ * pump extends over whole hours, up to PumpEngine::maxExtendedHours.
+ */
+bool parseExtended(std::istringstream& in, Scenario::Step& step)
+{
+    std::string word, percent, hours;
+    if (!(in >> word)) return true;
+    double pct = 0.0, hrs = 0.0;
+    if (word != "extended" || !(in >> percent >> hours) || !parseNumber(percent, pct, "%")
+        || !parseNumber(hours, hrs, "h") || pct <= 0.0 || pct >= 100.0 || hrs < 1.0
+        || hrs > PumpEngine::maxExtendedHours || hrs != std::floor(hrs))
+        return false;
+    step.fraction = pct / 100.0;
+    step.extendedHours = static_cast<int>(hrs);
+    return true;
+}
+
+bool parseStep(const std::string& keyword, std::istringstream& in, Scenario::Step& step)
+{
+    using Kind = Scenario::StepKind;
+    std::string a, b, c;
+    if (keyword == "at") {
+        step.kind = Kind::At;
+        return in >> a && parseTimeOfDay(a, step.value);
+    }
+    if (keyword == "wait") {
+        if (!(in >> a)) return false;
+        if (a != "until") {
+            step.kind = Kind::Wait;
+            return parseNumber(a, step.value, "m") && step.value >= 0.0;
+        }
+        // wait until bg < X [timeout N]
+        if (!(in >> a >> b >> c) || a != "bg" || (b != "<" && b != ">") || !parseNumber(c, step.value))
+            return false;
+        step.kind = b == "<" ? Kind::WaitBgBelow : Kind::WaitBgAbove;
+        std::string word, timeout;
+        if (!(in >> word)) return true;
+        double t = 0.0;
+        if (word != "timeout" || !(in >> timeout) || !parseNumber(timeout, t, "m") || t <= 0.0)
+            return false;
+        step.minutes = static_cast<int>(t);
+        return true;
+    }
+    if (keyword == "eat") {
+        step.kind = Kind::Eat;
+        step.minutes = static_cast<int>(AbsorptionSpeed::Medium);
+        if (!(in >> a) || !parseNumber(a, step.value, "g") || step.value <= 0.0) return false;
+        if (!(in >> b)) return true;
+        if (b == "fast") step.minutes = static_cast<int>(AbsorptionSpeed::Fast);
+        else if (b == "medium") step.minutes = static_cast<int>(AbsorptionSpeed::Medium);
+        else if (b == "slow") step.minutes = static_cast<int>(AbsorptionSpeed::Slow);
+        else return false;
+        return true;
+    }
+    if (keyword == "bolus" || keyword == "meal-bolus") {
+        step.kind = keyword == "bolus" ? Kind::Bolus : Kind::MealBolus;
+        return in >> a && parseNumber(a, step.value, keyword == "bolus" ? "U" : "g")
+            && step.value > 0.0 && parseExtended(in, step);
+    }
+    if (keyword == "exercise") {
+        step.kind = Kind::Exercise;
+        double minutes = 0.0;
+        if (!(in >> a) || !parseNumber(a, minutes, "m") || minutes <= 0.0) return false;
+        step.minutes = static_cast<int>(minutes);
+        step.fraction = 1.0;
+        if (!(in >> b)) return true;
+        if (b == "light") step.fraction = 0.5;
+        else if (b == "moderate") step.fraction = 1.0;
+        else if (b == "hard") step.fraction = 1.5;
+        else return false;
+        return true;
+    }
+    if (keyword == "sensor-bias") {
+        step.kind = Kind::SensorBias;
+        double minutes = 0.0;
+        if (!(in >> a >> b) || !parseNumber(a, step.value) || !parseNumber(b, minutes, "m") || minutes <= 0.0)
+            return false;
+        step.minutes = static_cast<int>(minutes);
+        return true;
+    }
+    if (keyword == "battery") {
+        step.kind = Kind::Battery;
+        return in >> a && parseNumber(a, step.value, "%") && step.value >= 0.0 && step.value <= 100.0;
+    }
+    if (keyword == "reservoir") {
+        step.kind = Kind::Reservoir;
+        return in >> a && parseNumber(a, step.value, "U") && step.value >= 0.0;
+    }
+    if (keyword == "loop") {
+        step.kind = Kind::Loop;
+        return true;
+    }
+    if (keyword == "repeat") {
+        step.kind = Kind::Repeat;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool Scenario::parse(const std::string& text, Scenario& out, std::string& error)
+{
+    std::vector<Step> parsed;
+    std::istringstream lines(text);
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(lines, line)) {
+        ++lineNo;
+        std::size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream in(line);
+        std::string keyword, extra;
+        if (!(in >> keyword)) continue;
+
+        Step step;
+        step.line = lineNo;
+        if (!parseStep(keyword, in, step) || in >> extra) {
+            error = "line " + std::to_string(lineNo) + ": cannot read \"" + line + "\"";
+            return false;
+        }
+        parsed.push_back(step);
+    }
+
+    out.steps = std::move(parsed);
+    out.source = text;
+    return true;
+}
+
+bool Scenario::load(const std::string& path, Scenario& out, std::string& error)
+{
+    std::ifstream file(path);
+    if (!file) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    if (!parse(text.str(), out, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+ScenarioRunner::ScenarioRunner(std::shared_ptr<const Scenario> scenario)
+    : scenario(std::move(scenario))
+{
+}
+
+/**
+ * @brief run executes the steps due now. A wait arms on its first visit
+ * (computing its wake time) and is then re-checked once per tick.
+ */
+void ScenarioRunner::run(PumpSimulation& sim)
+{
+    if (finished()) return;
+    PUMP_TRACE_SCOPE("scenario", "ScenarioRunner::run");
+
+    using Kind = Scenario::StepKind;
+    const std::vector<Scenario::Step>& steps = scenario->getSteps();
+    const SimTime now = sim.getSimClock().now();
+    CgmModel& cgm = sim.getCgmModel();
+    PumpEngine& engine = sim.getPumpEngine();
+    HistoryManager& history = sim.getHistoryManager();
+
+    double eatenNow = 0.0;   // carbs the calculator is told about rather than counts as on board
+
+    auto note = [&](const std::string& text) {
+        history.addRecord({ now, RecordType::Other, 0.0, text,
+                            sim.getProfileManager().getActiveVersion() });
+    };
+
+    for (int executed = 0; pc < steps.size() && executed < maxStepsPerTick; ++executed) {
+        const Scenario::Step& s = steps[pc];
+
+        if (waiting) {
+            bool done = now >= wakeTime;
+            if (s.kind == Kind::WaitBgBelow) done = done || cgm.getCurrentBg() < s.value;
+            if (s.kind == Kind::WaitBgAbove) done = done || cgm.getCurrentBg() > s.value;
+            if (!done) return;
+            waiting = false;
+            ++pc;
+            continue;
+        }
+
+        switch (s.kind) {
+        case Kind::At: {
+            SimTime at = now.startOfDay() + static_cast<long long>(s.value);
+            wakeTime = at < now ? at + SimTime::minutesPerDay : at;
+            waiting = true;
+            continue;
+        }
+        case Kind::Wait:
+            wakeTime = now + static_cast<long long>(s.value);
+            waiting = true;
+            continue;
+        case Kind::WaitBgBelow:
+        case Kind::WaitBgAbove:
+            wakeTime = s.minutes > 0 ? now + s.minutes : SimTime::latest();
+            waiting = true;
+            continue;
+        case Kind::Eat:
+            sim.getCarbs().addMeal(s.value, static_cast<AbsorptionSpeed>(s.minutes));
+            eatenNow += s.value;
+            note("Meal: " + formatFixed(s.value, 0) + " g carbs");
+            break;
+        case Kind::Bolus:
+            if (!engine.requestBolus(s.value, "Scenario bolus", s.fraction, s.extendedHours)) {
+                note("Bolus " + formatFixed(s.value, 2) + " U refused by the pump");
+            }
+            break;
+        case Kind::MealBolus: {
+            const GlucoseEstimator& est = cgm.getEstimator();
+            double bg = est.hasTrend() ? est.smoothedBg() : cgm.getCurrentBg();
+            double trend = est.hasTrend() ? est.rateOfChange() : 0.0;
+            double carbsOnBoard = std::max(sim.getCarbs().getCarbsOnBoard() - eatenNow, 0.0);
+            double units = BolusCalculator::suggestBolus(
+                BolusCalcParams::fromSettings(engine.getCurrentSettings()),
+                bg, s.value, engine.getInsulinOnBoard(), trend, carbsOnBoard);
+            units = std::round(units * 20.0) / 20.0;   // the pump's 0.05 U resolution
+            if (units > 0.0
+                && !engine.requestBolus(units, "Scenario meal bolus (" + formatFixed(s.value, 0) + " g)",
+                                        s.fraction, s.extendedHours)) {
+                note("Meal bolus " + formatFixed(units, 2) + " U for " + formatFixed(s.value, 0)
+                     + " g refused by the pump");
+            }
+            break;
+        }
+        case Kind::Exercise:
+            sim.getGlucoseResponse().startExercise(s.minutes, s.fraction);
+            note("Exercise: " + std::to_string(s.minutes) + " min");
+            break;
+        case Kind::SensorBias:
+            cgm.setSensorBias(s.value, s.minutes);
+            note("Sensor bias " + formatFixed(s.value, 1) + " mmol/L for "
+                 + std::to_string(s.minutes) + " min");
+            break;
+        case Kind::Battery:
+            sim.getDevice().setBatteryLevel(s.value);
+            break;
+        case Kind::Reservoir:
+            sim.getDevice().setReservoir(s.value);
+            break;
+        case Kind::Loop:
+            loopStart = pc + 1;
+            break;
+        case Kind::Repeat:
+            pc = loopStart;
+            return;
+        }
+        ++pc;
+    }
+}
+
+void ScenarioRunner::saveState(BinaryWriter& out) const
+{
+    out.putString(scenario ? scenario->getSource() : std::string());
+    out.put<std::uint8_t>(scenario ? 1 : 0);
+    out.put<std::uint64_t>(pc);
+    out.put<std::uint64_t>(loopStart);
+    out.put<std::uint8_t>(waiting ? 1 : 0);
+    out.put<std::int64_t>(wakeTime.minutes());
+}
+
+bool ScenarioRunner::restoreState(BinaryReader& in)
+{
+    std::string source;
+    std::uint8_t present = 0, wasWaiting = 0;
+    std::uint64_t savedPc = 0, savedLoop = 0;
+    std::int64_t wake = 0;
+    if (!in.getString(source) || !in.get(present) || !in.get(savedPc) || !in.get(savedLoop)
+        || !in.get(wasWaiting) || !in.get(wake))
+        return false;
+
+    std::shared_ptr<Scenario> parsed;
+    if (present) {
+        parsed = std::make_shared<Scenario>();
+        std::string error;
+        if (!Scenario::parse(source, *parsed, error) || savedPc > parsed->getSteps().size()
+            || savedLoop > parsed->getSteps().size())
+            return false;
+    }
+    scenario = std::move(parsed);
+    pc = static_cast<std::size_t>(savedPc);
+    loopStart = static_cast<std::size_t>(savedLoop);
+    waiting = wasWaiting != 0;
+    wakeTime = SimTime::fromMinutes(wake);
+    return true;
+}
@@ -0,0 +1,111 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "SimTime.h"
+
+class BinaryWriter;
+class BinaryReader;
+class PumpSimulation;
+
+/**
+ * @brief Scenario is a patient script: meals, boluses, exercise, sensor
+ * and device events, run in order on the simulated clock. One step per
+ * line, '#' starts a comment:
+ *
+ *     at 07:30                        wait for the next 07:30
+ *     wait 45                         wait 45 minutes
+ *     wait until bg < 5 [timeout 120] wait for a reading below 5 mmol/L
+ *     wait until bg > 10 [timeout N]
+ *     eat 60 [fast|medium|slow]       60 g of carbs (see CarbAbsorption)
+ *     bolus 4.5 [extended 40% 3h]     a manual bolus (extended over 1-24 whole hours)
+ *     meal-bolus 60 [extended 40% 3h] the bolus calculator's dose for 60 g
+ *     exercise 45 [light|moderate|hard]
+ *     sensor-bias -2.5 60             readings 2.5 mmol/L low for 60 minutes
+ *     battery 8                       battery at 8%
+ *     reservoir 4                     4 U left in the reservoir
+ *     loop                            where repeat jumps back to
+ *     repeat                          start again from loop (or the top)
+ *
+ * A bolus the pump refuses is noted in the history and the script
+ * carries on.
+ *
+ * A parsed Scenario is immutable and shared: every patient running it
+ * holds a ScenarioRunner with its own position in the script.
+ */
+class Scenario
+{
+public:
+    enum class StepKind {
+        At, Wait, WaitBgBelow, WaitBgAbove,
+        Eat, Bolus, MealBolus, Exercise, SensorBias, Battery, Reservoir,
+        Loop, Repeat
+    };
+
+    struct Step {
+        StepKind kind;
+        double value = 0.0;      // minute of day, minutes, mmol/L, g, U, %, ...
+        double fraction = 0.0;   // extended fraction; exercise intensity
+        int minutes = 0;         // timeout; duration; absorption speed
+        int extendedHours = 0;   // extended bolus duration, whole hours
+        int line = 0;
+    };
+
+    /**
+     * @brief parse reads a script; on failure out is unchanged and error
+     * names the offending line.
+     */
+    static bool parse(const std::string& text, Scenario& out, std::string& error);
+    static bool load(const std::string& path, Scenario& out, std::string& error);
+
+    const std::vector<Step>& getSteps() const { return steps; }
+    const std::string& getSource() const { return source; }
+
+private:
+    std::vector<Step> steps;
+    std::string source;
+};
+
+/**
+ * @brief ScenarioRunner is one patient's place in a Scenario. The
+ * simulation calls run() before each tick: due steps execute, and a
+ * waiting step is a single comparison against the clock or the latest
+ * reading, so thousands of scripted patients need no threads or timers.
+ * A runner is a small value: copying it (as forks do) shares the script.
+ *
+ * Steps run before the tick they are due on, so "at 07:30" acts on the
+ * glucose that the 07:35 reading shows. repeat ends the step's tick,
+ * which keeps a script without waits from spinning.
+ */
+class ScenarioRunner
+{
+public:
+    static constexpr int maxStepsPerTick = 64;
+
+    ScenarioRunner() = default;
+    explicit ScenarioRunner(std::shared_ptr<const Scenario> scenario);
+
+    bool hasScenario() const { return scenario != nullptr; }
+    bool finished() const { return !scenario || pc >= scenario->getSteps().size(); }
+    const Scenario* getScenario() const { return scenario.get(); }
+
+    void run(PumpSimulation& sim);
+
+    /**
+     * @brief Checkpoint support: the script's source and the position in it.
+     */
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    std::shared_ptr<const Scenario> scenario;
+    std::size_t pc = 0;
+    std::size_t loopStart = 0;
+    bool waiting = false;
+    SimTime wakeTime;   // At, Wait; the timeout of a BG wait
+};
+
+#endif // SCENARIO_H
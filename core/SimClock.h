@@ -0,0 +1,24 @@
+#ifndef SIMCLOCK_H
+#define SIMCLOCK_H
+
+#include "SimTime.h"
+
+/**
+ * @brief SimClock is the simulated wall clock (see SimTime). CgmModel
+ * advances it on every tick; anything that needs "now" (cooldowns,
+ * rolling limits) reads it instead of the real clock, so behaviour is
+ * identical at 1x and at any acceleration.
+ */
+class SimClock
+{
+public:
+    SimTime now() const { return time; }
+
+    void advance(int deltaMinutes) { time += deltaMinutes; }
+    void set(SimTime value) { time = value; }
+
+private:
+    SimTime time;
+};
+
+#endif // SIMCLOCK_H
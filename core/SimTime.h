@@ -0,0 +1,66 @@
+#ifndef SIMTIME_H
+#define SIMTIME_H
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief SimTime is a point in simulated time: whole minutes since the
+ * start of the run, which begins at midnight of day 0.
+ *
+ * It is a plain 64-bit integer, so comparing, sorting and indexing by
+ * time are integer operations and a run can span years. Differences are
+ * minutes (SimTime - SimTime), and minutes can be added to a SimTime;
+ * two SimTimes cannot be added, and a SimTime is never built implicitly
+ * from a number. Text is made only for display (see formatSimTime in
+ * StringUtil.h).
+ */
+class SimTime
+{
+public:
+    static constexpr long long minutesPerDay = 24 * 60;
+
+    constexpr SimTime() = default;
+
+    static constexpr SimTime fromMinutes(long long minutes) { return SimTime(minutes); }
+    static constexpr SimTime fromDay(long long day, long long minuteOfDay = 0)
+    {
+        return SimTime(day * minutesPerDay + minuteOfDay);
+    }
+    static constexpr SimTime earliest() { return SimTime(std::numeric_limits<long long>::min()); }
+    static constexpr SimTime latest() { return SimTime(std::numeric_limits<long long>::max()); }
+
+    constexpr long long minutes() const { return value; }
+
+    /**
+     * @brief Calendar day (0-based) and minute within it; both floor, so
+     * a time before the start of the run is on day -1.
+     */
+    constexpr long long day() const
+    {
+        return value >= 0 ? value / minutesPerDay : (value + 1) / minutesPerDay - 1;
+    }
+    constexpr int minuteOfDay() const { return static_cast<int>(value - day() * minutesPerDay); }
+    constexpr SimTime startOfDay() const { return SimTime(day() * minutesPerDay); }
+
+    constexpr SimTime& operator+=(long long minutes) { value += minutes; return *this; }
+    constexpr SimTime& operator-=(long long minutes) { value -= minutes; return *this; }
+
+    friend constexpr SimTime operator+(SimTime t, long long minutes) { return SimTime(t.value + minutes); }
+    friend constexpr SimTime operator-(SimTime t, long long minutes) { return SimTime(t.value - minutes); }
+    friend constexpr long long operator-(SimTime a, SimTime b) { return a.value - b.value; }
+
+    friend constexpr bool operator==(SimTime a, SimTime b) { return a.value == b.value; }
+    friend constexpr bool operator!=(SimTime a, SimTime b) { return a.value != b.value; }
+    friend constexpr bool operator<(SimTime a, SimTime b) { return a.value < b.value; }
+    friend constexpr bool operator<=(SimTime a, SimTime b) { return a.value <= b.value; }
+    friend constexpr bool operator>(SimTime a, SimTime b) { return a.value > b.value; }
+    friend constexpr bool operator>=(SimTime a, SimTime b) { return a.value >= b.value; }
+
+private:
+    explicit constexpr SimTime(long long minutes) : value(minutes) {}
+
+    long long value = 0;
+};
+
+#endif // SIMTIME_H
@@ -0,0 +1,42 @@
+#ifndef STRINGUTIL_H
+#define STRINGUTIL_H
+
+#include <cstdio>
+#include <string>
+#include "SimTime.h"
+
+/**
+ * @brief formatFixed renders a value with a fixed number of decimals,
+ * the plain C++ equivalent of QString::arg(value, 0, 'f', decimals).
+ */
+inline std::string formatFixed(double value, int decimals)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    return buf;
+}
+
+/**
+ * @brief formatTimeOfDay renders a simulated time as "HH:MM" on its day.
+ */
+inline std::string formatTimeOfDay(SimTime time)
+{
+    char buf[16];
+    int minute = time.minuteOfDay();
+    std::snprintf(buf, sizeof(buf), "%02d:%02d", minute / 60, minute % 60);
+    return buf;
+}
+
+/**
+ * @brief formatSimTime renders a simulated time as "Day N HH:MM", days
+ * counted from 1, the form history and alerts are shown in.
+ */
+inline std::string formatSimTime(SimTime time)
+{
+    char buf[40];
+    int minute = time.minuteOfDay();
+    std::snprintf(buf, sizeof(buf), "Day %lld %02d:%02d", time.day() + 1, minute / 60, minute % 60);
+    return buf;
+}
+
+#endif // STRINGUTIL_H
@@ -0,0 +1,248 @@
+#include "TelemetryFeed.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(TelemetrySlot) == 64, "a slot should be one cache line");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "sequence numbers are shared between processes");
+
+namespace {
+
+const char feedMagic[8] = "PUMPTLM";
+
+std::string shmPath(const std::string& name)
+{
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+std::size_t bytesFor(std::size_t capacity)
+{
+    return sizeof(TelemetryHeader) + capacity * sizeof(TelemetrySlot);
+}
+
+} // namespace
+
+TelemetryFeed::~TelemetryFeed()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool TelemetryFeed::create(const std::string&, std::size_t, std::string& error)
+{
+    error = "Telemetry feeds need POSIX shared memory";
+    return false;
+}
+
+void TelemetryFeed::close() {}
+
+bool TelemetryReader::open(const std::string&, std::string& error)
+{
+    error = "Telemetry feeds need POSIX shared memory";
+    return false;
+}
+
+void TelemetryReader::close() {}
+
+#else
+
+bool TelemetryFeed::create(const std::string& name, std::size_t capacity, std::string& error)
+{
+    close();
+    std::size_t slotCount = 1;
+    while (slotCount < std::max<std::size_t>(capacity, 2)) slotCount <<= 1;
+
+    std::string path = shmPath(name);
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        error = "Cannot create shared memory " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    std::size_t bytes = bytesFor(slotCount);
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        error = "Cannot size shared memory " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        error = "Cannot map shared memory " + path + ": " + std::strerror(errno);
+        shm_unlink(path.c_str());
+        return false;
+    }
+
+    // The new object is zero-filled: every slot reads as never written
+    header = new (memory) TelemetryHeader();
+    header->version = version;
+    header->slotBytes = sizeof(TelemetrySlot);
+    header->capacity = slotCount;
+    slots = reinterpret_cast<TelemetrySlot*>(static_cast<char*>(memory) + sizeof(TelemetryHeader));
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, feedMagic, sizeof(feedMagic));
+
+    shmName = path;
+    mappedBytes = bytes;
+    mask = slotCount - 1;
+    next = 0;
+    return true;
+}
+
+void TelemetryFeed::close()
+{
+    if (!header) return;
+    munmap(header, mappedBytes);
+    shm_unlink(shmName.c_str());
+    header = nullptr;
+    slots = nullptr;
+    mappedBytes = 0;
+}
+
+bool TelemetryReader::open(const std::string& name, std::string& error)
+{
+    close();
+    std::string path = shmPath(name);
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        error = "Cannot open shared memory " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(TelemetryHeader)) {
+        error = path + " is not a telemetry feed";
+        ::close(fd);
+        return false;
+    }
+    std::size_t bytes = static_cast<std::size_t>(st.st_size);
+    void* memory = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        error = "Cannot map shared memory " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    const TelemetryHeader* h = static_cast<const TelemetryHeader*>(memory);
+    bool valid = std::memcmp(h->magic, feedMagic, sizeof(feedMagic)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid || h->version != TelemetryFeed::version || h->slotBytes != sizeof(TelemetrySlot)
+        || h->capacity < 2 || (h->capacity & (h->capacity - 1)) != 0
+        || bytes < bytesFor(h->capacity)) {
+        error = valid && h->version != TelemetryFeed::version
+            ? path + " has telemetry version " + std::to_string(h->version)
+            : path + " is not a telemetry feed (or is still being created)";
+        munmap(memory, bytes);
+        return false;
+    }
+
+    header = h;
+    slots = reinterpret_cast<const TelemetrySlot*>(static_cast<const char*>(memory) + sizeof(TelemetryHeader));
+    mappedBytes = bytes;
+    mask = h->capacity - 1;
+    lostEvents = 0;
+    seekToLatest();
+    return true;
+}
+
+void TelemetryReader::close()
+{
+    if (!header) return;
+    munmap(const_cast<TelemetryHeader*>(header), mappedBytes);
+    header = nullptr;
+    slots = nullptr;
+    mappedBytes = 0;
+}
+
+#endif
+
+/**
+ * @brief publish writes the slot between an odd and an even sequence
+ * number, then advances the header's count for readers that want to
+ * know how far behind they are. It touches nothing a reader writes.
+ */
+void TelemetryFeed::publish(TelemetryEvent event)
+{
+    if (!header) return;
+    event.timeNs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+
+    TelemetrySlot& slot = slots[next & mask];
+    slot.sequence.store(2 * next + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event = event;
+    slot.sequence.store(2 * next + 2, std::memory_order_release);
+    ++next;
+    header->published.store(next, std::memory_order_release);
+}
+
+TelemetryReader::~TelemetryReader()
+{
+    close();
+}
+
+std::uint64_t TelemetryReader::published() const
+{
+    return header ? header->published.load(std::memory_order_acquire) : 0;
+}
+
+void TelemetryReader::seekToLatest()
+{
+    next = published();
+}
+
+void TelemetryReader::seekToOldest()
+{
+    std::uint64_t head = published();
+    next = head > mask + 1 ? head - (mask + 1) : 0;
+}
+
+const TelemetryEvent* TelemetryReader::peek()
+{
+    if (!slots) return nullptr;
+    for (;;) {
+        const TelemetrySlot& slot = slots[next & mask];
+        std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == 2 * next + 2) return &slot.event;
+        if (sequence < 2 * next + 2) return nullptr;   // not written, or being written
+        skipLapped();
+    }
+}
+
+bool TelemetryReader::consume()
+{
+    if (!slots) return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slots[next & mask].sequence.load(std::memory_order_relaxed) == 2 * next + 2) {
+        ++next;
+        return true;
+    }
+    skipLapped();
+    return false;
+}
+
+/**
+ * @brief skipLapped moves to the oldest event the producer cannot be
+ * overwriting yet: one it started (the slot's sequence) or finished
+ * (the header's count) less a full ring.
+ */
+void TelemetryReader::skipLapped()
+{
+    std::uint64_t sequence = slots[next & mask].sequence.load(std::memory_order_acquire);
+    std::uint64_t head = std::max(published(), (sequence + 1) / 2);
+    std::uint64_t oldest = head > mask + 1 ? head - mask : 0;
+    oldest = std::max(oldest, next + 1);
+    lostEvents += oldest - next;
+    next = oldest;
+}
@@ -0,0 +1,168 @@
+#ifndef TELEMETRYFEED_H
+#define TELEMETRYFEED_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief What a telemetry event reports; the detail byte depends on it.
+ */
+enum class TelemetryKind : std::uint8_t {
+    CgmReading = 1,   // bg = reading
+    Decision = 2,     // detail = ControlAction, bg = predicted BG, rate = basal U/h, units = auto bolus
+    Delivery = 3,     // detail = DeliveryKind, units = insulin delivered
+    BolusBlocked = 4  // detail = BolusBlockReason, units = dose refused
+};
+
+enum class DeliveryKind : std::uint8_t {
+    ManualBolus,
+    AutoBolus,
+    ExtendedSlice   // part of an extended bolus infused over the last interval
+};
+
+/**
+ * @brief One fixed-size, plain-data event; with its slot's sequence
+ * number it fills one 64-byte cache line.
+ */
+struct TelemetryEvent {
+    std::uint64_t timeNs = 0;        // steady clock when published (comparable across processes on Linux)
+    std::int64_t simMinute = 0;
+    double bg = 0.0;
+    double units = 0.0;
+    double rate = 0.0;
+    double insulinOnBoard = 0.0;
+    std::uint32_t pump = 0;
+    TelemetryKind kind = TelemetryKind::CgmReading;
+    std::uint8_t detail = 0;
+    std::uint16_t reserved = 0;
+};
+
+/**
+ * @brief Shared-memory layout: a header, then a power-of-two ring of slots.
+ *
+ * Event n goes into slot n % capacity. The slot's sequence is 2n+1
+ * while it is being written and 2n+2 once it is complete (a per-slot
+ * seqlock), so a reader can tell a finished event from one in progress
+ * and from a newer event that lapped it, without any shared lock.
+ */
+struct alignas(64) TelemetrySlot {
+    std::atomic<std::uint64_t> sequence;
+    TelemetryEvent event;
+};
+
+struct TelemetryHeader {
+    char magic[8];                          // "PUMPTLM", written last
+    std::uint32_t version;
+    std::uint32_t slotBytes;
+    std::uint64_t capacity;
+    alignas(64) std::atomic<std::uint64_t> published;   // events written so far
+};
+
+/**
+ * @brief TelemetryFeed is the producer side of a telemetry ring in POSIX
+ * shared memory (shm_open, so /dev/shm/<name> on Linux).
+ *
+ * publish() never waits for and never looks at readers: when the ring
+ * is full the oldest events are overwritten and slow readers find out
+ * from the sequence numbers. There must be one producer per feed; the
+ * engines of several pumps may share one if they all run on one thread.
+ * The shared memory is unlinked when the feed is closed or destroyed.
+ */
+class TelemetryFeed
+{
+public:
+    static constexpr std::uint32_t version = 1;
+    static constexpr std::size_t defaultCapacity = 1u << 16;
+
+    TelemetryFeed() = default;
+    ~TelemetryFeed();
+
+    TelemetryFeed(const TelemetryFeed&) = delete;
+    TelemetryFeed& operator=(const TelemetryFeed&) = delete;
+
+    /**
+     * @brief create makes (or replaces) the feed called name ("pumpsim"
+     * or "/pumpsim") with room for capacity events, rounded up to a power
+     * of two. Readers already attached to a replaced feed keep the old one.
+     */
+    bool create(const std::string& name, std::size_t capacity, std::string& error);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    /**
+     * @brief publish stamps timeNs and appends event. No-op when closed.
+     */
+    void publish(TelemetryEvent event);
+
+    std::uint64_t published() const { return next; }
+    std::size_t capacity() const { return mask + 1; }
+
+private:
+    std::string shmName;
+    TelemetryHeader* header = nullptr;
+    TelemetrySlot* slots = nullptr;
+    std::size_t mappedBytes = 0;
+    std::size_t mask = 0;
+    std::uint64_t next = 0;
+};
+
+/**
+ * @brief TelemetryReader tails a feed in place, with no copies.
+ *
+ * peek() returns a pointer into the shared ring; after reading the
+ * fields, consume() checks the slot was not overwritten in the meantime.
+ * If it was, what was read must be discarded; the reader has then
+ * skipped to the oldest event still in the ring and counted the events
+ * it missed in lost(). Readers never write to the shared memory, so any
+ * number of them can follow one producer.
+ */
+class TelemetryReader
+{
+public:
+    TelemetryReader() = default;
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    /**
+     * @brief open attaches to an existing feed, positioned at its next
+     * event (seekToOldest() to replay what the ring still holds).
+     */
+    bool open(const std::string& name, std::string& error);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    void seekToLatest();
+    void seekToOldest();
+
+    /**
+     * @brief peek returns the next event in the ring, or null if the
+     * producer has not completed it yet. Valid until consume().
+     */
+    const TelemetryEvent* peek();
+
+    /**
+     * @brief consume moves past the peeked event.
+     * @return false if it was overwritten while being read
+     */
+    bool consume();
+
+    std::uint64_t position() const { return next; }
+    std::uint64_t lost() const { return lostEvents; }
+    std::uint64_t published() const;
+
+private:
+    const TelemetryHeader* header = nullptr;
+    const TelemetrySlot* slots = nullptr;
+    std::size_t mappedBytes = 0;
+    std::size_t mask = 0;
+    std::uint64_t next = 0;
+    std::uint64_t lostEvents = 0;
+
+    void skipLapped();
+};
+
+#endif // TELEMETRYFEED_H
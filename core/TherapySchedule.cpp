@@ -0,0 +1,37 @@
+#include "TherapySchedule.h"
+#include <algorithm>
+
+TherapySchedule::TherapySchedule()
+    : TherapySchedule(UserProfile())
+{
+}
+
+/**
+ * @brief Sorts the segments by start, then paints each one's index over the
+ * slots from its start to the end of the day; later segments overwrite
+ * the tail. Starts are rounded down to a slot; extra segments beyond
+ * maxSegments are ignored.
+ */
+TherapySchedule::TherapySchedule(const UserProfile& profile)
+    : slotIndex()
+    , settings()
+{
+    settings[0] = profile.baseSettings();
+    slotIndex.fill(0);
+
+    std::vector<TherapySegment> sorted(profile.segments);
+    if (sorted.size() > static_cast<std::size_t>(UserProfile::maxSegments)) {
+        sorted.resize(UserProfile::maxSegments);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const TherapySegment& a, const TherapySegment& b) {
+                         return a.startMinute < b.startMinute;
+                     });
+
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        int start = std::clamp(sorted[i].startMinute, 0, 24 * 60 - 1) / slotMinutes;
+        settings[i + 1] = sorted[i].settings;
+        std::fill(slotIndex.begin() + start, slotIndex.end(),
+                  static_cast<std::uint8_t>(i + 1));
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef THERAPYSCHEDULE_H
+#define THERAPYSCHEDULE_H
+
+#include <array>
+#include <cstdint>
+#include "SimTime.h"
+#include "UserProfile.h"
+
+/**
+ * @brief TherapySchedule is a profile's segments compiled into a lookup
+ * table with one entry per 5-minute slot of the day. Each slot holds a
+ * one-byte index into at most 17 distinct settings (the base settings
+ * plus 16 segments), so the whole table is under 1 KB and at() is two
+ * loads with no segment search.
+ */
+class TherapySchedule
+{
+public:
+    static constexpr int slotMinutes = 5;
+    static constexpr int slotsPerDay = 24 * 60 / slotMinutes;
+
+    TherapySchedule();
+    explicit TherapySchedule(const UserProfile& profile);
+
+    /**
+     * @brief Settings in force at a simulated time, on any day of the run.
+     */
+    const TherapySettings& at(SimTime time) const
+    {
+        return settings[slotIndex[time.minuteOfDay() / slotMinutes]];
+    }
+
+private:
+    std::array<std::uint8_t, slotsPerDay> slotIndex;
+    std::array<TherapySettings, UserProfile::maxSegments + 1> settings;
+};
+
+#endif // THERAPYSCHEDULE_H
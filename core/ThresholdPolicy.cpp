@@ -0,0 +1,22 @@
+#include "ThresholdPolicy.h"
+
+ControllerDecision ThresholdPolicy::decide(const ControllerInput& in)
+{
+    ControllerDecision d;
+    if (!in.hasTrend) {
+        // Not enough data for a 30min trend
+        return d;
+    }
+    d.predictedBg = in.bg + in.trend * 30.0;
+
+    if (d.predictedBg < 3.9) {
+        d.action = ControlAction::SuspendBasal;
+    } else if (d.predictedBg >= 14.0) {
+        d.action = ControlAction::AutoBolus;
+        d.bolusUnits = 1.0;
+    } else if (d.predictedBg >= 10.0) {
+        d.action = ControlAction::AdjustBasal;
+        d.basalRate = in.settings.basalRate * 1.5;
+    }
+    return d;
+}
@@ -0,0 +1,22 @@
+#ifndef THRESHOLDPOLICY_H
+#define THRESHOLDPOLICY_H
+
+#include "ControllerPolicy.h"
+
+/**
+ * @brief The original Control-IQ rule: predict BG 30 min ahead as
+ * bg + trend * 30, with the trend from GlucoseEstimator, and decide
+ * nothing until it has one. If predicted <3.9, suspend. If >=14,
+ * auto-correct 1U. If >=10, raise basal by a fixed 50%.
+ */
+class ThresholdPolicy
+{
+public:
+    ControllerDecision decide(const ControllerInput& in);
+
+    // Stateless: nothing to checkpoint
+    void saveState(BinaryWriter&) const {}
+    bool restoreState(BinaryReader&) { return true; }
+};
+
+#endif // THRESHOLDPOLICY_H
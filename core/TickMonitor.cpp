@@ -0,0 +1,66 @@
+#include "TickMonitor.h"
+#include <chrono>
+
+TickMonitor::TickMonitor(MetricsRegistry& registry, std::uint64_t periodNs, std::uint64_t budgetNs)
+    : periodNs(periodNs)
+    , budgetNs(budgetNs)
+    , lastStartNs(0)
+    , currentStartNs(0)
+    , jitter(registry.histogram("pump_loop_tick_jitter_seconds", "Deviation of each tick interval from the nominal period."))
+    , processing(registry.histogram("pump_loop_tick_processing_seconds", "Wall time spent inside each loop tick."))
+    , ticks(registry.counter("pump_loop_ticks_total", "Loop ticks observed."))
+    , deadlineMisses(registry.counter("pump_loop_deadline_misses_total", "Ticks that started later than period + budget."))
+    , missedPeriods(registry.counter("pump_loop_missed_periods_total", "Whole periods that passed without a tick."))
+    , overruns(registry.counter("pump_loop_overruns_total", "Ticks whose processing exceeded the budget."))
+{
+}
+
+std::uint64_t TickMonitor::nowNs()
+{
+    auto t = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t).count());
+}
+
+void TickMonitor::tickStarted(std::uint64_t startNs)
+{
+    ticks.add();
+    currentStartNs = startNs;
+
+    if (lastStartNs != 0 && startNs > lastStartNs) {
+        std::uint64_t interval = startNs - lastStartNs;
+        jitter.record(interval > periodNs ? interval - periodNs : periodNs - interval);
+
+        if (interval > periodNs + budgetNs) {
+            deadlineMisses.add();
+            // One tick per period is due; this one covers interval / period of them
+            std::uint64_t covered = interval / periodNs;
+            if (covered > 1) missedPeriods.add(covered - 1);
+        }
+    }
+    lastStartNs = startNs;
+}
+
+void TickMonitor::tickFinished(std::uint64_t endNs)
+{
+    if (currentStartNs == 0 || endNs < currentStartNs) return;
+
+    std::uint64_t spent = endNs - currentStartNs;
+    processing.record(spent);
+    if (spent > budgetNs) {
+        overruns.add();
+    }
+    currentStartNs = 0;
+}
+
+TickMonitor::Summary TickMonitor::summary() const
+{
+    Summary s;
+    s.ticks = ticks.get();
+    s.deadlineMisses = deadlineMisses.get();
+    s.missedPeriods = missedPeriods.get();
+    s.overruns = overruns.get();
+    s.jitterP99Ns = jitter.quantile(0.99);
+    s.jitterMaxNs = jitter.max();
+    s.processingP99Ns = processing.quantile(0.99);
+    return s;
+}
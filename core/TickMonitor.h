@@ -0,0 +1,68 @@
+#ifndef TICKMONITOR_H
+#define TICKMONITOR_H
+
+#include <cstdint>
+#include "Metrics.h"
+
+/**
+ * @brief TickMonitor watches the cadence of a periodic simulation loop.
+ *
+ * Each tick reports when it started and finished. The monitor compares
+ * the interval since the previous start with the nominal period and the
+ * tick's own processing time with the budget:
+ *  - jitter: |interval - period|, into a histogram
+ *  - deadline miss: the tick started more than budget after it was due
+ *  - missed periods: whole periods that passed with no tick at all
+ *  - overrun: processing took longer than budget
+ * Everything is registered in a MetricsRegistry, so it shows up in the
+ * same dump as the pump's metrics. Times are steady-clock nanoseconds.
+ */
+class TickMonitor
+{
+public:
+    struct Summary {
+        std::uint64_t ticks = 0;
+        std::uint64_t deadlineMisses = 0;
+        std::uint64_t missedPeriods = 0;
+        std::uint64_t overruns = 0;
+        std::uint64_t jitterP99Ns = 0;
+        std::uint64_t jitterMaxNs = 0;
+        std::uint64_t processingP99Ns = 0;
+    };
+
+    TickMonitor(MetricsRegistry& registry, std::uint64_t periodNs, std::uint64_t budgetNs);
+
+    TickMonitor(const TickMonitor&) = delete;
+    TickMonitor& operator=(const TickMonitor&) = delete;
+
+    static std::uint64_t nowNs();
+
+    void tickStarted(std::uint64_t startNs);
+    void tickFinished(std::uint64_t endNs);
+
+    /**
+     * @brief Forget the previous start, e.g. after the loop was paused on
+     * purpose, so the gap is not counted as a miss.
+     */
+    void resync() { lastStartNs = 0; }
+
+    Summary summary() const;
+
+    std::uint64_t getPeriodNs() const { return periodNs; }
+    std::uint64_t getBudgetNs() const { return budgetNs; }
+
+private:
+    std::uint64_t periodNs;
+    std::uint64_t budgetNs;
+    std::uint64_t lastStartNs;
+    std::uint64_t currentStartNs;
+
+    LatencyHistogram& jitter;
+    LatencyHistogram& processing;
+    Counter& ticks;
+    Counter& deadlineMisses;
+    Counter& missedPeriods;
+    Counter& overruns;
+};
+
+#endif // TICKMONITOR_H
@@ -0,0 +1,172 @@
+#include "Trace.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* category;
+    const char* name;
+    std::uint64_t startNs;
+    std::uint64_t durationNs;
+};
+
+/**
+ * @brief One thread's ring. Only the owning thread writes; head is
+ * published with release so a reader sees complete events.
+ */
+struct ThreadBuffer {
+    static constexpr std::size_t capacity = 1 << 16;
+
+    std::array<TraceEvent, capacity> events;
+    std::atomic<std::uint64_t> head { 0 };
+    std::uint32_t threadId = 0;
+};
+
+std::atomic<bool> enabledFlag { false };
+
+std::mutex registryMutex;
+
+/**
+ * @brief Every ring ever made, and the ones whose thread has exited.
+ * Rings are never freed, so a late dump still sees an exited thread's
+ * events; a new thread takes an idle ring and carries on after them, so
+ * short-lived threads (e.g. preview workers) do not add a ring each.
+ */
+struct Registry {
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer*> idle;
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+/**
+ * @brief The calling thread's hold on a ring, handed back when it exits.
+ */
+struct BufferLease {
+    ThreadBuffer* buffer = nullptr;
+
+    ~BufferLease()
+    {
+        if (!buffer) return;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry().idle.push_back(buffer);
+    }
+};
+
+ThreadBuffer& localBuffer()
+{
+    thread_local BufferLease lease;
+    if (!lease.buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        Registry& r = registry();
+        if (!r.idle.empty()) {
+            lease.buffer = r.idle.back();
+            r.idle.pop_back();
+        } else {
+            r.buffers.push_back(std::make_unique<ThreadBuffer>());
+            lease.buffer = r.buffers.back().get();
+            lease.buffer->threadId = static_cast<std::uint32_t>(r.buffers.size());
+        }
+    }
+    return *lease.buffer;
+}
+
+const std::chrono::steady_clock::time_point& epoch()
+{
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return start;
+}
+
+void writeJsonString(std::FILE* f, const char* s)
+{
+    std::fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', f);
+        std::fputc(*s, f);
+    }
+    std::fputc('"', f);
+}
+
+} // namespace
+
+void Trace::setEnabled(bool enabled)
+{
+    epoch();
+    enabledFlag.store(enabled, std::memory_order_relaxed);
+}
+
+bool Trace::isEnabled()
+{
+    return enabledFlag.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Trace::nowNs()
+{
+    auto elapsed = std::chrono::steady_clock::now() - epoch();
+    // Never 0, which TraceScope uses for "not recording"
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) + 1;
+}
+
+void Trace::record(const char* category, const char* name, std::uint64_t startNs, std::uint64_t endNs)
+{
+    ThreadBuffer& buffer = localBuffer();
+    std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % ThreadBuffer::capacity] = { category, name, startNs, endNs - startNs };
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+/**
+ * @brief writeChromeJson dumps every ring as "X" (complete) events,
+ * timestamps in microseconds, plus a thread_name entry per ring. Threads
+ * that used the same ring one after another share its tid.
+ */
+bool Trace::writeChromeJson(const std::string& path, std::string& error)
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        error = "Cannot open " + path + " for writing.";
+        return false;
+    }
+
+    std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& buffer : registry().buffers) {
+            std::fprintf(f, "%s\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,"
+                            "\"args\":{\"name\":\"thread %u\"}}",
+                         first ? "" : ",", buffer->threadId, buffer->threadId);
+            first = false;
+
+            std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+            std::uint64_t begin = head > ThreadBuffer::capacity ? head - ThreadBuffer::capacity : 0;
+            for (std::uint64_t i = begin; i < head; ++i) {
+                const TraceEvent& e = buffer->events[i % ThreadBuffer::capacity];
+                std::fprintf(f, ",\n{\"ph\":\"X\",\"cat\":");
+                writeJsonString(f, e.category);
+                std::fprintf(f, ",\"name\":");
+                writeJsonString(f, e.name);
+                std::fprintf(f, ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                             buffer->threadId, e.startNs / 1000.0, e.durationNs / 1000.0);
+            }
+        }
+    }
+    std::fprintf(f, "\n]}\n");
+
+    bool ok = std::ferror(f) == 0;
+    if (std::fclose(f) != 0) ok = false;
+    if (!ok) {
+        error = "Failed writing " + path + ".";
+    }
+    return ok;
+}
@@ -0,0 +1,79 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Scoped trace points for the CGM-to-decision pipeline, written
+ * as Chrome trace-event JSON (loads in chrome://tracing and Perfetto).
+ *
+ * Build with PUMPCORE_TRACE defined (qmake CONFIG+=trace) to compile
+ * the trace points in; otherwise PUMP_TRACE_SCOPE expands to nothing.
+ * When compiled in, recording is still off until setEnabled(true), and
+ * an off trace point costs one relaxed atomic load.
+ *
+ * Each thread writes complete events into its own fixed-size ring with
+ * no locks; only a thread's first event takes the registry mutex. When
+ * a ring fills, the oldest events are overwritten. A thread's ring is
+ * reused by a later thread once it exits, so memory grows with the most
+ * threads tracing at once, not with every thread ever started. writeChromeJson is
+ * meant to run when the pipeline is idle (e.g. on exit).
+ */
+namespace Trace {
+
+void setEnabled(bool enabled);
+bool isEnabled();
+
+/**
+ * @brief Nanoseconds since the trace epoch (first use in this process).
+ */
+std::uint64_t nowNs();
+
+/**
+ * @brief record adds a complete event to the calling thread's ring.
+ * category and name must be string literals (only the pointers are kept).
+ */
+void record(const char* category, const char* name, std::uint64_t startNs, std::uint64_t endNs);
+
+bool writeChromeJson(const std::string& path, std::string& error);
+
+} // namespace Trace
+
+/**
+ * @brief TraceScope records one event covering its own lifetime.
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char* category, const char* name)
+        : category(category)
+        , name(name)
+        , startNs(Trace::isEnabled() ? Trace::nowNs() : 0)
+    {}
+
+    ~TraceScope()
+    {
+        if (startNs) Trace::record(category, name, startNs, Trace::nowNs());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* category;
+    const char* name;
+    std::uint64_t startNs;
+};
+
+#define PUMP_TRACE_CONCAT2(a, b) a##b
+#define PUMP_TRACE_CONCAT(a, b) PUMP_TRACE_CONCAT2(a, b)
+
+#ifdef PUMPCORE_TRACE
+#define PUMP_TRACE_SCOPE(category, name) \
+    TraceScope PUMP_TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+#else
+#define PUMP_TRACE_SCOPE(category, name) do {} while (0)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,60 @@
+#ifndef USERPROFILE_H
+#define USERPROFILE_H
+
+#include <string>
+#include <vector>
+#include "SafetyLimits.h"
+
+/**
+ * @brief The four dosing settings that can vary by time of day.
+ */
+struct TherapySettings {
+    double basalRate;         // U/hour
+    double carbRatio;         // grams per 1U
+    double correctionFactor;  // mmol/L per 1U
+    double targetGlucose;     // mmol/L
+};
+
+/**
+ * @brief A time segment: settings that apply from startMinute
+ * (minutes after midnight) until the next segment starts.
+ */
+struct TherapySegment {
+    int startMinute;
+    TherapySettings settings;
+};
+
+/**
+ * @brief Data structure representing a user's basal rate, carb ratio,
+ * correction factor, and target glucose for insulin dosing, plus the
+ * safety limits bolus requests are checked against.
+ *
+ * The flat settings apply from midnight; optional segments (up to
+ * maxSegments) override them from their start time onwards. Use
+ * TherapySchedule to look the settings up by time.
+ */
+struct UserProfile {
+    static constexpr int maxSegments = 16;
+
+    std::string name;
+    double basalRate;         // U/hour
+    double carbRatio;         // grams per 1U
+    double correctionFactor;  // mmol/L per 1U
+    double targetGlucose;     // mmol/L
+    std::vector<TherapySegment> segments;
+    SafetyLimits safetyLimits;
+
+    UserProfile()
+        : basalRate(0)
+        , carbRatio(0)
+        , correctionFactor(0)
+        , targetGlucose(5)
+    {}
+
+    TherapySettings baseSettings() const
+    {
+        return { basalRate, carbRatio, correctionFactor, targetGlucose };
+    }
+};
+
+#endif // USERPROFILE_H
@@ -0,0 +1,164 @@
+#include "UserProfileManager.h"
+#include "BinaryIo.h"
+
+UserProfileManager::UserProfileManager()
+    : activeIndex(0)
+    , activeSnapshot(nullptr)
+    , nextVersion(1)
+{
+    // Provide a default profile
+    UserProfile defaultP;
+    defaultP.name = "Default";
+    defaultP.basalRate = 1.0;
+    defaultP.carbRatio = 10.0;
+    defaultP.correctionFactor = 2.0;
+    defaultP.targetGlucose = 6.0;
+
+    store.add(defaultP);
+    publish(defaultP);
+}
+
+void UserProfileManager::loadProfile(const UserProfile &profile)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    activeIndex = -1;
+    publish(profile);
+}
+
+void UserProfileManager::activateProfile(int index)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (index >= 0 && index < getProfileCount()) {
+        activeIndex = index;
+        publish(store.get(index));
+    }
+}
+
+const UserProfile& UserProfileManager::getActiveProfile() const
+{
+    return getActiveSnapshot()->profile;
+}
+
+const ProfileSnapshot* UserProfileManager::getActiveSnapshot() const
+{
+    return activeSnapshot.load(std::memory_order_acquire);
+}
+
+std::uint64_t UserProfileManager::getActiveVersion() const
+{
+    return getActiveSnapshot()->version;
+}
+
+int UserProfileManager::getProfileCount() const
+{
+    return static_cast<int>(store.size());
+}
+
+const std::string& UserProfileManager::getProfileName(int index) const
+{
+    return store.nameAt(index);
+}
+
+const UserProfile& UserProfileManager::getProfile(int index)
+{
+    return store.get(index);
+}
+
+int UserProfileManager::findProfile(const std::string& name) const
+{
+    return static_cast<int>(store.findByName(name));
+}
+
+void UserProfileManager::addProfile(const UserProfile &profile)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    store.add(profile);
+}
+
+void UserProfileManager::updateProfile(int index, const UserProfile &profile)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (index >= 0 && index < getProfileCount()) {
+        store.update(index, profile);
+        if (index == activeIndex) {
+            publish(profile);
+        }
+    }
+}
+
+/**
+ * @brief Deleting the active entry leaves its snapshot active, detached
+ * from the library (as if it had been loaded with loadProfile).
+ */
+void UserProfileManager::deleteProfile(int index)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (index >= 0 && index < getProfileCount()) {
+        store.remove(index);
+        if (index == activeIndex) {
+            activeIndex = -1;
+        } else if (index < activeIndex) {
+            --activeIndex;
+        }
+    }
+}
+
+bool UserProfileManager::loadLibrary(const std::string& path, std::string& error)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    ProfileStore loaded;
+    if (!loaded.open(path, error)) {
+        return false;
+    }
+    store = std::move(loaded);
+    if (store.size() > 0) {
+        activeIndex = 0;
+        publish(store.get(0));
+    } else {
+        activeIndex = -1;
+    }
+    return true;
+}
+
+bool UserProfileManager::saveLibrary(const std::string& path, std::string& error)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return store.save(path, error);
+}
+
+void UserProfileManager::saveState(BinaryWriter& out) const
+{
+    const ProfileSnapshot* active = getActiveSnapshot();
+    out.put(active->version);
+    encodeProfile(out, active->profile);
+}
+
+bool UserProfileManager::restoreState(BinaryReader& in)
+{
+    std::uint64_t version = 0;
+    UserProfile profile;
+    if (!in.get(version) || !decodeProfile(in, profile)) return false;
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    activeIndex = -1;
+    if (nextVersion <= version) nextVersion = version + 1;
+    publish(profile, version);
+    return true;
+}
+
+/**
+ * @brief publish builds the next snapshot (compiling the schedule once,
+ * off the readers' path) and swaps it in. Caller holds
+ * writeMutex (or is the constructor).
+ */
+void UserProfileManager::publish(const UserProfile& profile)
+{
+    publish(profile, nextVersion++);
+}
+
+void UserProfileManager::publish(const UserProfile& profile, std::uint64_t version)
+{
+    snapshots.push_back(std::unique_ptr<const ProfileSnapshot>(
+        new ProfileSnapshot{ profile, TherapySchedule(profile), version }));
+    activeSnapshot.store(snapshots.back().get(), std::memory_order_release);
+}
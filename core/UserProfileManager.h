@@ -0,0 +1,105 @@
+#ifndef USERPROFILEMANAGER_H
+#define USERPROFILEMANAGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ProfileStore.h"
+#include "TherapySchedule.h"
+#include "UserProfile.h"
+
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief An immutable, versioned copy of the active profile, with its
+ * time-of-day schedule already compiled.
+ * Every activation or edit of the active profile publishes a new one.
+ */
+struct ProfileSnapshot {
+    UserProfile profile;
+    TherapySchedule schedule;
+    std::uint64_t version;
+};
+
+/**
+ * @brief Manages a collection of UserProfiles and tracks the currently active one.
+ *
+ * The active profile is published read-copy-update style: writers build a
+ * new ProfileSnapshot and swap the pointer atomically, so readers on any
+ * thread get it with one acquire load, no lock and no copy. Retired
+ * snapshots are kept until the manager is destroyed (edits are rare and
+ * a snapshot is small), so a pointer or reference handed out stays valid.
+ *
+ * The profile library lives in a ProfileStore and can be saved to and
+ * loaded from disk; full profiles are only decoded when asked for. The
+ * library accessors are for the GUI thread; writers are serialised by a
+ * mutex.
+ */
+class UserProfileManager
+{
+public:
+    UserProfileManager();
+
+    /**
+     * @brief Activates a copy of profile that is not tied to the library.
+     */
+    void loadProfile(const UserProfile& profile);
+
+    /**
+     * @brief Activates library entry index; later edits to it republish it.
+     */
+    void activateProfile(int index);
+
+    const UserProfile& getActiveProfile() const;
+    const ProfileSnapshot* getActiveSnapshot() const;
+    std::uint64_t getActiveVersion() const;
+
+    int getProfileCount() const;
+    const std::string& getProfileName(int index) const;
+    const UserProfile& getProfile(int index);
+
+    /**
+     * @return the index of the first profile with that name, or -1.
+     */
+    int findProfile(const std::string& name) const;
+
+    void addProfile(const UserProfile& profile);
+    void updateProfile(int index, const UserProfile& profile);
+    void deleteProfile(int index);
+
+    /**
+     * @brief Replaces the library with the store at path and activates its
+     * first profile. On failure the library is unchanged.
+     */
+    bool loadLibrary(const std::string& path, std::string& error);
+    bool saveLibrary(const std::string& path, std::string& error);
+    bool hasUnsavedChanges() const { return store.isDirty(); }
+
+    /**
+     * @brief Checkpoint support: the active profile and its version.
+     * Restoring activates the profile detached from the library (like
+     * loadProfile) under the saved version, so history records made
+     * before and after the checkpoint agree; later versions continue
+     * from there. The library itself is saved with saveLibrary.
+     */
+    void saveState(BinaryWriter& out) const;
+    bool restoreState(BinaryReader& in);
+
+private:
+    ProfileStore store;
+    int activeIndex;
+
+    std::atomic<const ProfileSnapshot*> activeSnapshot;
+    std::vector<std::unique_ptr<const ProfileSnapshot>> snapshots;
+    std::uint64_t nextVersion;
+    std::mutex writeMutex;
+
+    void publish(const UserProfile& profile);
+    void publish(const UserProfile& profile, std::uint64_t version);
+};
+
+#endif // USERPROFILEMANAGER_H
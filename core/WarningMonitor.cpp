@@ -0,0 +1,51 @@
+#include "WarningMonitor.h"
+#include "HistoryRecord.h"
+#include "StringUtil.h"
+#include "Trace.h"
+
+WarningMonitor::WarningMonitor(HistoryManager* hist, CgmModel* cgm)
+    : history(hist),
+      cgmModel(cgm)
+{
+}
+
+/**
+ * @brief check is called every 30s and checks the BG thresholds.
+ */
+std::vector<std::string> WarningMonitor::check()
+{
+    PUMP_TRACE_SCOPE("warning", "WarningMonitor::check");
+    std::vector<std::string> raised;
+
+    // BG warnings (critically low <3.9 or high >13.9) on smoothed BG so a
+    // single noisy reading does not raise them; warn ahead of a low as well
+    if (cgmModel) {
+        const GlucoseEstimator& estimator = cgmModel->getEstimator();
+        double bg = estimator.hasTrend() ? estimator.smoothedBg() : cgmModel->getCurrentBg();
+        if (bg < 3.9) {
+            logWarning("BG critically low (" + formatFixed(bg, 1) + ")!", raised);
+        } else if (bg > 13.9) {
+            logWarning("BG critically high (" + formatFixed(bg, 1) + ")!", raised);
+        } else if (estimator.hasTrend() && estimator.predict(30.0) < 3.9) {
+            logWarning("BG predicted low in 30 min (" + formatFixed(estimator.predict(30.0), 1) + ")!", raised);
+        }
+    }
+
+    return raised;
+}
+
+/**
+ * @brief logWarning writes a record to HistoryManager and queues it for the UI.
+ */
+void WarningMonitor::logWarning(const std::string& msg, std::vector<std::string>& raised)
+{
+    if (!history || !cgmModel) return;
+
+    history->addRecord({
+        cgmModel->getSimTime(),
+        RecordType::Warning,
+        0.0,
+        msg
+    });
+    raised.push_back(msg);
+}
@@ -0,0 +1,33 @@
+#ifndef WARNINGMONITOR_H
+#define WARNINGMONITOR_H
+
+#include <string>
+#include <vector>
+#include "HistoryManager.h"
+#include "CgmModel.h"
+
+/**
+ * @brief WarningMonitor checks BG to produce warnings (RecordType::Warning).
+ * It logs these and hands them back so a front end (WarningChecker) can
+ * alert the user. Battery and reservoir warnings come from PumpDevice
+ * as they happen.
+ */
+class WarningMonitor
+{
+public:
+    WarningMonitor(HistoryManager* hist, CgmModel* cgm);
+
+    /**
+     * @brief check runs one 30s check cycle.
+     * @return the warnings raised during this cycle (already logged)
+     */
+    std::vector<std::string> check();
+
+private:
+    HistoryManager* history;
+    CgmModel*       cgmModel;
+
+    void logWarning(const std::string& msg, std::vector<std::string>& raised);
+};
+
+#endif // WARNINGMONITOR_H
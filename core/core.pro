@@ -0,0 +1,86 @@
+# Qt-free simulation and control logic, built as a static library
+# shared by the GUI (app/) and the headless runner (headless/).
+TEMPLATE = lib
+TARGET = pumpcore
+
+CONFIG += staticlib c++17
+CONFIG -= qt
+
+# qmake CONFIG+=trace compiles the PUMP_TRACE_SCOPE points in (see Trace.h)
+trace: DEFINES += PUMPCORE_TRACE
+
+SOURCES += \
+    AgpReport.cpp \
+    BolusCalculator.cpp \
+    BolusPreview.cpp \
+    BolusSafetyManager.cpp \
+    CarbAbsorption.cpp \
+    CgmModel.cpp \
+    CohortAlerts.cpp \
+    ControlIQ.cpp \
+    GlucoseEstimator.cpp \
+    GlucoseResponse.cpp \
+    HistoryManager.cpp \
+    HistoryRecord.cpp \
+    InsulinOnBoard.cpp \
+    Metrics.cpp \
+    MpcPolicy.cpp \
+    PidPolicy.cpp \
+    PumpDevice.cpp \
+    PumpEngine.cpp \
+    PumpMetrics.cpp \
+    ProfileStore.cpp \
+    PumpSimulation.cpp \
+    QuantileSketch.cpp \
+    RollingTotal.cpp \
+    SafetyRules.cpp \
+    Scenario.cpp \
+    TelemetryFeed.cpp \
+    TherapySchedule.cpp \
+    ThresholdPolicy.cpp \
+    TickMonitor.cpp \
+    Trace.cpp \
+    UserProfileManager.cpp \
+    WarningMonitor.cpp
+
+HEADERS += \
+    AgpReport.h \
+    BinaryIo.h \
+    BolusCalculator.h \
+    BolusPreview.h \
+    BolusSafetyManager.h \
+    BoxQp.h \
+    CarbAbsorption.h \
+    CgmModel.h \
+    CohortAlerts.h \
+    ControlIQ.h \
+    ControllerPolicy.h \
+    GlucoseEstimator.h \
+    GlucoseResponse.h \
+    HistoryManager.h \
+    HistoryRecord.h \
+    InsulinOnBoard.h \
+    Metrics.h \
+    MpcPolicy.h \
+    PidPolicy.h \
+    PumpDevice.h \
+    PumpEngine.h \
+    PumpMetrics.h \
+    ProfileStore.h \
+    PumpSimulation.h \
+    QuantileSketch.h \
+    RollingTotal.h \
+    SafetyLimits.h \
+    SafetyRules.h \
+    Scenario.h \
+    SimClock.h \
+    SimTime.h \
+    StringUtil.h \
+    TelemetryFeed.h \
+    TherapySchedule.h \
+    ThresholdPolicy.h \
+    TickMonitor.h \
+    Trace.h \
+    UserProfile.h \
+    UserProfileManager.h \
+    WarningMonitor.h
@@ -0,0 +1,20 @@
+# Include this from a sibling subproject to link against libpumpcore.
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+trace: DEFINES += PUMPCORE_TRACE
+
+# The core uses std::mutex/std::thread (trace buffers, metrics, pacing, bolus previews)
+CONFIG += thread
+
+# TelemetryFeed uses shm_open, which older glibc keeps in librt
+linux: LIBS += -lrt
+
+win32:CONFIG(release, debug|release): PUMPCORE_DIR = $$OUT_PWD/../core/release
+else:win32:CONFIG(debug, debug|release): PUMPCORE_DIR = $$OUT_PWD/../core/debug
+else: PUMPCORE_DIR = $$OUT_PWD/../core
+
+LIBS += -L$$PUMPCORE_DIR -lpumpcore
+
+win32:!win32-g++: PRE_TARGETDEPS += $$PUMPCORE_DIR/pumpcore.lib
+else: PRE_TARGETDEPS += $$PUMPCORE_DIR/libpumpcore.a
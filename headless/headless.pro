@@ -0,0 +1,11 @@
+# Console runner: drives PumpSimulation in a tight loop, no Qt required.
+TEMPLATE = app
+TARGET = pumpsim-headless
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../core/pumpcore.pri)
+
+SOURCES += \
+    main.cpp
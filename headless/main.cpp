@@ -0,0 +1,200 @@
+#include "AgpReport.h"
+#include "PumpSimulation.h"
+#include "TelemetryFeed.h"
+#include "HistoryRecord.h"
+#include "ControlIQ.h"
+#include "StringUtil.h"
+#include "TickMonitor.h"
+#include "Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <thread>
+
+/**
+ * @brief Headless entry point. Runs the pump core for a number of CGM
+ * ticks as fast as possible and prints a short summary.
+ *
+ * Usage: pumpsim-headless [--ticks N] [--seed S] [--controller threshold|pid|mpc]
+ *                         [--trace FILE] [--metrics FILE [--metrics-every N]]
+ *                         [--period-ms P] [--resume FILE] [--checkpoint FILE]
+ *                         [--scenario FILE] [--telemetry NAME] [--agp]
+ *
+ * --trace writes Chrome trace JSON (needs a PUMPCORE_TRACE build).
+ * --metrics writes Prometheus-style text metrics at the end of the run,
+ * and every N ticks with --metrics-every, for watching long runs.
+ * --period-ms paces the loop at one tick per P ms, as the GUI timer does,
+ * and reports its cadence (late ticks, skipped periods, overruns).
+ * --resume continues from a checkpoint (its controller and full state);
+ * --checkpoint saves the pump state at the end of the run.
+ * --scenario scripts the patient (meals, exercise, sensor and device
+ * events, see Scenario) and turns physiology on.
+ * --telemetry publishes readings, decisions and deliveries to the
+ * shared-memory feed NAME (see TelemetryFeed; tail it with pumpsim-telemetry).
+ * --agp prints the Ambulatory Glucose Profile of the run's readings
+ * (5th-95th percentiles by hour of day; see AgpProfile).
+ */
+int main(int argc, char *argv[])
+{
+    long long ticks = 288;   // one simulated day
+    unsigned seed = 1;
+    ControllerKind controller = ControllerKind::Threshold;
+    const char* tracePath = nullptr;
+    const char* metricsPath = nullptr;
+    long long metricsEvery = 0;
+    long long periodMs = 0;
+    const char* resumePath = nullptr;
+    const char* checkpointPath = nullptr;
+    const char* scenarioPath = nullptr;
+    const char* telemetryName = nullptr;
+    bool agp = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--controller") == 0 && i + 1 < argc
+                   && parseControllerKind(argv[i + 1], controller)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            metricsPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--metrics-every") == 0 && i + 1 < argc) {
+            metricsEvery = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--period-ms") == 0 && i + 1 < argc) {
+            periodMs = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--resume") == 0 && i + 1 < argc) {
+            resumePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            checkpointPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            scenarioPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetryName = argv[++i];
+        } else if (std::strcmp(argv[i], "--agp") == 0) {
+            agp = true;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--ticks N] [--seed S] [--controller threshold|pid|mpc] [--trace FILE] [--metrics FILE [--metrics-every N]] [--period-ms P] [--resume FILE] [--checkpoint FILE] [--scenario FILE] [--telemetry NAME] [--agp]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Trace::setEnabled(tracePath != nullptr);
+    auto started = std::chrono::steady_clock::now();
+
+    PumpSimulation sim(seed);
+    sim.getPumpEngine().setController(controller);
+    std::string error;
+    if (resumePath) {
+        if (!sim.loadCheckpoint(resumePath, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        controller = sim.getPumpEngine().getControllerKind();
+    }
+    if (scenarioPath) {
+        auto scenario = std::make_shared<Scenario>();
+        if (!Scenario::load(scenarioPath, *scenario, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        sim.setScenario(scenario);
+    }
+    TelemetryFeed telemetry;
+    if (telemetryName) {
+        if (!telemetry.create(telemetryName, TelemetryFeed::defaultCapacity, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        sim.getPumpEngine().setTelemetry(&telemetry);
+    }
+    // Only a paced loop has a cadence to monitor; budget 10% of the
+    // period, as in the GUI
+    const std::uint64_t periodNs = static_cast<std::uint64_t>(periodMs) * 1000000ull;
+    std::optional<TickMonitor> monitor;
+    if (periodMs > 0) monitor.emplace(sim.getMetrics().registry, periodNs, periodNs / 10 + 1);
+    auto due = std::chrono::steady_clock::now();
+    long long inRange = 0;
+    AgpProfile profile;
+
+    for (long long t = 0; t < ticks; ++t) {
+        if (periodMs > 0) {
+            due += std::chrono::milliseconds(periodMs);
+            std::this_thread::sleep_until(due);
+            monitor->tickStarted(TickMonitor::nowNs());
+        }
+        double bg = sim.step();
+        if (bg >= 3.9 && bg <= 10.0) ++inRange;
+        if (agp) profile.add(sim.getSimClock().now(), bg);
+        if (periodMs > 0) {
+            monitor->tickFinished(TickMonitor::nowNs());
+        }
+        if (metricsPath && metricsEvery > 0 && (t + 1) % metricsEvery == 0
+            && !sim.getMetrics().registry.writeText(metricsPath, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    double ms = std::chrono::duration<double, std::milli>(elapsed).count();
+
+    int autoBoluses = 0, manualBoluses = 0, warnings = 0;
+    for (const HistoryRecord& rec : sim.getHistoryManager().getRecords()) {
+        if (rec.getRecordType() == RecordType::AutoBolus)   ++autoBoluses;
+        if (rec.getRecordType() == RecordType::ManualBolus) ++manualBoluses;
+        if (rec.getRecordType() == RecordType::Warning)     ++warnings;
+    }
+
+    std::printf("controller:     %s\n", controllerName(controller));
+    std::printf("ticks:          %lld\n", ticks);
+    std::printf("sim time:       %s\n", formatSimTime(sim.getSimClock().now()).c_str());
+    std::printf("final BG:       %.1f mmol/L\n", sim.getCgmModel().getCurrentBg());
+    std::printf("time in range:  %.1f%% (3.9-10 mmol/L)\n", ticks > 0 ? 100.0 * inRange / ticks : 0.0);
+    std::printf("history:        %zu records\n", sim.getHistoryManager().getRecords().size());
+    std::printf("auto boluses:   %d\n", autoBoluses);
+    std::printf("manual boluses: %d\n", manualBoluses);
+    std::printf("warnings:       %d\n", warnings);
+    std::printf("reservoir:      %.1f U, battery %d%%\n",
+                sim.getDevice().getReservoir(), sim.getDevice().getBatteryPercent());
+    std::printf("elapsed:        %.3f ms\n", ms);
+    if (periodMs > 0) {
+        TickMonitor::Summary loop = monitor->summary();
+        std::printf("loop:           %llu late, %llu skipped, %llu overruns, jitter p99 %.3f ms, max %.3f ms\n",
+                    static_cast<unsigned long long>(loop.deadlineMisses),
+                    static_cast<unsigned long long>(loop.missedPeriods),
+                    static_cast<unsigned long long>(loop.overruns),
+                    loop.jitterP99Ns / 1e6, loop.jitterMaxNs / 1e6);
+    }
+    if (agp) {
+        const int binsPerHour = 60 / AgpProfile::binMinutes;
+        std::printf("AGP (mmol/L):   time    n     5%%    25%%    50%%    75%%    95%%\n");
+        for (int hour = 0; hour < 24; ++hour) {
+            AgpBin b = profile.bin(hour * binsPerHour, binsPerHour);
+            if (b.readings == 0) continue;
+            std::printf("                %s %4llu %6.1f %6.1f %6.1f %6.1f %6.1f\n",
+                        formatTimeOfDay(SimTime::fromDay(0, hour * 60)).c_str(),
+                        static_cast<unsigned long long>(b.readings), b.p5, b.p25, b.p50, b.p75, b.p95);
+        }
+    }
+
+    if (checkpointPath && !sim.saveCheckpoint(checkpointPath, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    if (metricsPath && !sim.getMetrics().registry.writeText(metricsPath, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    if (tracePath) {
+        if (!Trace::writeChromeJson(tracePath, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,19 @@
+# Load generator for pumpsim-server: many pumps, streams and bolus round trips.
+TEMPLATE = app
+TARGET = pumpsim-loadgen
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../core/pumpcore.pri)
+
+INCLUDEPATH += ../server
+
+SOURCES += \
+    ../server/Protocol.cpp \
+    ../server/PumpClient.cpp \
+    main.cpp
+
+HEADERS += \
+    ../server/Protocol.h \
+    ../server/PumpClient.h
@@ -0,0 +1,237 @@
+#include "Metrics.h"
+#include "PumpClient.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::uint64_t nowNs()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct Options {
+    std::string socketPath = "/tmp/pumpsim.sock";
+    int pumps = 1000;
+    int connections = 4;
+    int ticks = 288;
+    bool subscribe = true;
+};
+
+/**
+ * @brief Waits until count threads have arrived.
+ */
+class Barrier
+{
+public:
+    explicit Barrier(int count) : remaining(count) {}
+
+    void arrive()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (--remaining == 0) {
+            ready.notify_all();
+        } else {
+            ready.wait(lock, [this] { return remaining == 0; });
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    int remaining;
+};
+
+struct Shared {
+    std::atomic<bool> stop { false };
+    std::atomic<std::uint64_t> streamMessages { 0 };
+    std::atomic<std::uint64_t> boluses { 0 };
+    std::atomic<std::uint64_t> delivered { 0 };
+    std::atomic<int> failures { 0 };
+    LatencyHistogram bolusLatency;
+    LatencyHistogram advanceLatency;
+};
+
+/**
+ * @brief waitFor reads frames until the reply to request, counting
+ * stream messages on the way.
+ */
+bool waitFor(PumpClient& client, std::uint32_t request, Protocol::MessageType& type,
+             BinaryReader& payload, Shared& shared)
+{
+    using Protocol::MessageType;
+    while (client.receive(type, payload)) {
+        if (type == MessageType::CgmReading || type == MessageType::HistoryEvent) {
+            shared.streamMessages.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        std::uint32_t echoed = 0;
+        BinaryReader peek = payload;
+        if (peek.get(echoed) && echoed == request) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief One client connection: creates its share of the fleet, then
+ * sends boluses one at a time, timing each round trip, until told to stop.
+ */
+void runClient(const Options& opt, int index, int pumpCount, Barrier& barrier, Shared& shared)
+{
+    PumpClient client;
+    std::string error;
+    if (!client.connect(opt.socketPath, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        shared.failures++;
+        barrier.arrive();
+        return;
+    }
+
+    // Creation and subscription are pipelined: one write, then the replies
+    std::vector<std::uint32_t> pumpIds;
+    std::uint32_t last = 0;
+    for (int i = 0; i < pumpCount; ++i) {
+        Protocol::CreatePump m;
+        m.request = last = client.nextRequest();
+        m.seed = static_cast<std::uint32_t>(index * 100000 + i);
+        m.controller = static_cast<ControllerKind>(i % 3);
+        Protocol::encode(client.outbox(), m);
+    }
+    client.flush();
+    Protocol::MessageType type;
+    BinaryReader payload(nullptr, 0);
+    for (int i = 0; i < pumpCount; ++i) {
+        std::uint32_t request = 0, pump = 0;
+        if (!client.receive(type, payload) || type != Protocol::MessageType::PumpCreated
+            || !payload.get(request) || !payload.get(pump)) {
+            std::fprintf(stderr, "client %d: CreatePump failed\n", index);
+            shared.failures++;
+            barrier.arrive();
+            return;
+        }
+        pumpIds.push_back(pump);
+    }
+    if (opt.subscribe) {
+        for (std::uint32_t id : pumpIds) {
+            Protocol::encode(client.outbox(), Protocol::Subscribe { last = client.nextRequest(), id,
+                                                                    Protocol::StreamCgm | Protocol::StreamHistory });
+        }
+        client.flush();
+        if (!waitFor(client, last, type, payload, shared)) shared.failures++;
+    }
+    barrier.arrive();
+
+    std::size_t next = 0;
+    while (!shared.stop.load(std::memory_order_relaxed) && !pumpIds.empty()) {
+        Protocol::RequestBolus m;
+        m.request = client.nextRequest();
+        m.pump = pumpIds[next++ % pumpIds.size()];
+        m.units = 0.05;
+        Protocol::encode(client.outbox(), m);
+        std::uint64_t started = nowNs();
+        if (!client.flush() || !waitFor(client, m.request, type, payload, shared)) {
+            shared.failures++;
+            return;
+        }
+        shared.bolusLatency.record(nowNs() - started);
+        shared.boluses++;
+        std::uint32_t request = 0;
+        std::uint8_t ok = 0;
+        if (type == Protocol::MessageType::BolusResult && payload.get(request) && payload.get(ok) && ok) {
+            shared.delivered++;
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief pumpsim-loadgen drives a running pumpsim-server: each of
+ * --connections clients creates its share of --pumps pumps and
+ * subscribes to their CGM and history streams, then requests boluses in
+ * a loop while a driver connection advances the fleet --ticks times.
+ * Reports fleet throughput and bolus round-trip latency.
+ *
+ * Usage: pumpsim-loadgen [--socket PATH] [--pumps N] [--connections C]
+ *                        [--ticks T] [--no-subscribe]
+ */
+int main(int argc, char *argv[])
+{
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            opt.socketPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--pumps") == 0 && i + 1 < argc) {
+            opt.pumps = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--connections") == 0 && i + 1 < argc) {
+            opt.connections = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            opt.ticks = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--no-subscribe") == 0) {
+            opt.subscribe = false;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--socket PATH] [--pumps N] [--connections C] [--ticks T] [--no-subscribe]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (opt.connections < 1) opt.connections = 1;
+
+    PumpClient driver;
+    std::string error;
+    if (!driver.connect(opt.socketPath, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    Shared shared;
+    Barrier barrier(opt.connections + 1);
+    std::vector<std::thread> clients;
+    for (int c = 0; c < opt.connections; ++c) {
+        int share = opt.pumps / opt.connections + (c < opt.pumps % opt.connections ? 1 : 0);
+        clients.emplace_back(runClient, std::cref(opt), c, share, std::ref(barrier), std::ref(shared));
+    }
+    barrier.arrive();
+
+    auto started = std::chrono::steady_clock::now();
+    Protocol::MessageType type;
+    BinaryReader payload(nullptr, 0);
+    for (int t = 0; t < opt.ticks && shared.failures == 0; ++t) {
+        std::uint32_t request = driver.nextRequest();
+        Protocol::encode(driver.outbox(), Protocol::Advance { request, 1 });
+        std::uint64_t sent = nowNs();
+        if (!driver.flush() || !waitFor(driver, request, type, payload, shared)) {
+            std::fprintf(stderr, "Advance failed\n");
+            shared.failures++;
+            break;
+        }
+        shared.advanceLatency.record(nowNs() - sent);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    shared.stop = true;
+    for (std::thread& t : clients) {
+        t.join();
+    }
+
+    const double pumpTicks = static_cast<double>(opt.pumps) * opt.ticks;
+    std::printf("pumps:            %d over %d connections\n", opt.pumps, opt.connections);
+    std::printf("ticks:            %d in %.3f s (%.0f pump-ticks/s)\n", opt.ticks, seconds, pumpTicks / seconds);
+    std::printf("advance:          p50 %.3f ms, p99 %.3f ms\n",
+                shared.advanceLatency.quantile(0.5) / 1e6, shared.advanceLatency.quantile(0.99) / 1e6);
+    std::printf("bolus round trip: %llu requests (%llu delivered), p50 %.1f us, p99 %.1f us, max %.1f us\n",
+                static_cast<unsigned long long>(shared.boluses.load()),
+                static_cast<unsigned long long>(shared.delivered.load()),
+                shared.bolusLatency.quantile(0.5) / 1e3, shared.bolusLatency.quantile(0.99) / 1e3,
+                shared.bolusLatency.max() / 1e3);
+    std::printf("stream messages:  %llu (%.0f/s)\n",
+                static_cast<unsigned long long>(shared.streamMessages.load()),
+                shared.streamMessages.load() / seconds);
+    return shared.failures == 0 ? 0 : 1;
+}
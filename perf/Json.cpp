@@ -0,0 +1,179 @@
+#include "Json.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+/**
+ * @brief Recursive-descent parser over the whole text; pos is the
+ * index of the next unread character.
+ */
+class Parser
+{
+public:
+    explicit Parser(const std::string& text) : text(text), pos(0) {}
+
+    bool parse(JsonValue& out, std::string& error)
+    {
+        if (!value(out, error)) return false;
+        skipSpace();
+        if (pos != text.size()) return fail("trailing characters", error);
+        return true;
+    }
+
+private:
+    const std::string& text;
+    std::size_t pos;
+
+    bool fail(const char* what, std::string& error)
+    {
+        error = std::string("JSON: ") + what + " at offset " + std::to_string(pos);
+        return false;
+    }
+
+    void skipSpace()
+    {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t')) {
+            ++pos;
+        }
+    }
+
+    bool literal(const char* word)
+    {
+        std::size_t n = std::char_traits<char>::length(word);
+        if (text.compare(pos, n, word) != 0) return false;
+        pos += n;
+        return true;
+    }
+
+    bool value(JsonValue& out, std::string& error)
+    {
+        skipSpace();
+        if (pos >= text.size()) return fail("unexpected end", error);
+
+        char c = text[pos];
+        if (c == '{') return object(out, error);
+        if (c == '[') return array(out, error);
+        if (c == '"') {
+            out.type = JsonValue::Type::String;
+            return string(out.string, error);
+        }
+        if (literal("true"))  { out.type = JsonValue::Type::Bool; out.boolean = true;  return true; }
+        if (literal("false")) { out.type = JsonValue::Type::Bool; out.boolean = false; return true; }
+        if (literal("null"))  { out.type = JsonValue::Type::Null; return true; }
+
+        const char* start = text.c_str() + pos;
+        char* end = nullptr;
+        out.number = std::strtod(start, &end);
+        if (end == start) return fail("unexpected character", error);
+        out.type = JsonValue::Type::Number;
+        pos += static_cast<std::size_t>(end - start);
+        return true;
+    }
+
+    bool string(std::string& out, std::string& error)
+    {
+        ++pos;  // opening quote
+        out.clear();
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c == '\\') {
+                if (pos >= text.size()) break;
+                char e = text[pos++];
+                switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u':
+                    // Only ASCII escapes are expected in our files
+                    if (pos + 4 > text.size()) return fail("bad \\u escape", error);
+                    out += static_cast<char>(std::strtol(text.substr(pos, 4).c_str(), nullptr, 16) & 0x7f);
+                    pos += 4;
+                    break;
+                default:  out += e; break;
+                }
+            } else {
+                out += c;
+            }
+        }
+        if (pos >= text.size()) return fail("unterminated string", error);
+        ++pos;  // closing quote
+        return true;
+    }
+
+    bool array(JsonValue& out, std::string& error)
+    {
+        out.type = JsonValue::Type::Array;
+        ++pos;
+        skipSpace();
+        if (pos < text.size() && text[pos] == ']') { ++pos; return true; }
+        for (;;) {
+            out.array.emplace_back();
+            if (!value(out.array.back(), error)) return false;
+            skipSpace();
+            if (pos < text.size() && text[pos] == ',') { ++pos; continue; }
+            if (pos < text.size() && text[pos] == ']') { ++pos; return true; }
+            return fail("expected , or ]", error);
+        }
+    }
+
+    bool object(JsonValue& out, std::string& error)
+    {
+        out.type = JsonValue::Type::Object;
+        ++pos;
+        skipSpace();
+        if (pos < text.size() && text[pos] == '}') { ++pos; return true; }
+        for (;;) {
+            skipSpace();
+            if (pos >= text.size() || text[pos] != '"') return fail("expected member name", error);
+            out.object.emplace_back();
+            if (!string(out.object.back().first, error)) return false;
+            skipSpace();
+            if (pos >= text.size() || text[pos] != ':') return fail("expected :", error);
+            ++pos;
+            if (!value(out.object.back().second, error)) return false;
+            skipSpace();
+            if (pos < text.size() && text[pos] == ',') { ++pos; continue; }
+            if (pos < text.size() && text[pos] == '}') { ++pos; return true; }
+            return fail("expected , or }", error);
+        }
+    }
+};
+
+} // namespace
+
+const JsonValue* JsonValue::find(const std::string& key) const
+{
+    if (type != Type::Object) return nullptr;
+    for (const auto& member : object) {
+        if (member.first == key) return &member.second;
+    }
+    return nullptr;
+}
+
+double JsonValue::numberOr(const std::string& key, double fallback) const
+{
+    const JsonValue* v = find(key);
+    return v && v->type == Type::Number ? v->number : fallback;
+}
+
+bool parseJson(const std::string& text, JsonValue& out, std::string& error)
+{
+    out = JsonValue();
+    return Parser(text).parse(out, error);
+}
+
+bool readJsonFile(const std::string& path, JsonValue& out, std::string& error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    return parseJson(buffer.str(), out, error);
+}
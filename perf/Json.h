@@ -0,0 +1,33 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Minimal JSON document model, enough to read baseline files back.
+ * Numbers are doubles; object members keep file order.
+ */
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    /**
+     * @brief Member by key, or null when absent or not an object.
+     */
+    const JsonValue* find(const std::string& key) const;
+
+    double numberOr(const std::string& key, double fallback) const;
+};
+
+bool parseJson(const std::string& text, JsonValue& out, std::string& error);
+bool readJsonFile(const std::string& path, JsonValue& out, std::string& error);
+
+#endif // JSON_H
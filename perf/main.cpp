@@ -0,0 +1,324 @@
+#include "Bench.h"
+#include "CohortAlerts.h"
+#include "ControlIQ.h"
+#include "Json.h"
+#include "PumpSimulation.h"
+#include "StringUtil.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief A deterministic workload: a cohort of pumps with fixed seeds and
+ * profiles, meal boluses at fixed times and cohort alerts every tick, run
+ * through the same PumpSimulation/PumpEngine/HistoryManager stack the
+ * GUI uses.
+ */
+struct Workload {
+    const char* name;
+    int pumps;
+    int days;
+    ControllerKind controller;
+    int mealsPerDay;      // manual boluses through PumpEngine::requestBolus
+    double mealBolus;     // U; large values exercise the safety rules
+};
+
+const Workload scenarios[] = {
+    { "cohort-week-threshold", 40, 7, ControllerKind::Threshold, 3, 4.0 },
+    { "cohort-week-pid",       40, 7, ControllerKind::Pid,       3, 4.0 },
+    { "cohort-week-mpc",       40, 7, ControllerKind::Mpc,       3, 4.0 },
+    { "bolus-heavy-threshold", 40, 7, ControllerKind::Threshold, 24, 6.0 },
+};
+
+struct Measurement {
+    double ticksPerSecond = 0.0;
+    double allocsPerTick = 0.0;
+    long peakRssKb = 0;
+    std::uint64_t historyRecords = 0;
+};
+
+struct Tolerances {
+    double throughput = 0.20;  // fraction slower allowed
+    double allocs = 0.02;      // fraction more allowed
+    double rss = 0.15;
+};
+
+UserProfile scenarioProfile(int index)
+{
+    UserProfile p;
+    p.name = "perf-" + std::to_string(index);
+    p.basalRate = 0.6 + (index % 8) * 0.1;
+    p.carbRatio = 8.0 + index % 6;
+    p.correctionFactor = 1.5 + (index % 4) * 0.5;
+    p.targetGlucose = 6.0;
+    p.segments.push_back({ 6 * 60, { p.basalRate * 1.2, p.carbRatio, p.correctionFactor, 6.0 } });
+    p.segments.push_back({ 22 * 60, { p.basalRate * 0.8, p.carbRatio, p.correctionFactor, 6.5 } });
+    return p;
+}
+
+long peakRssKb()
+{
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // bytes there
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+/**
+ * @brief runScenario executes one scenario in the calling process.
+ */
+Measurement runScenario(const Workload& s)
+{
+    const int ticksPerDay = 288;
+    const int ticks = s.days * ticksPerDay;
+    const int mealEvery = ticksPerDay / s.mealsPerDay;
+
+    std::uint64_t allocsBefore = BenchAlloc::count();
+    auto started = std::chrono::steady_clock::now();
+
+    std::vector<std::unique_ptr<PumpSimulation>> pumps;
+    for (int i = 0; i < s.pumps; ++i) {
+        pumps.push_back(std::make_unique<PumpSimulation>(1000u + static_cast<unsigned>(i)));
+        pumps.back()->getProfileManager().loadProfile(scenarioProfile(i));
+        pumps.back()->getPumpEngine().setController(s.controller);
+    }
+
+    // Alerts for the whole cohort in one pass per tick; BG alerts are
+    // logged as WarningMonitor would (the device logs its own)
+    CohortAlerts alerts(pumps.size());
+    std::vector<double> bg(pumps.size()), reservoir(pumps.size()), battery(pumps.size());
+    const AlertLevels levels { bg.data(), reservoir.data(), battery.data(), pumps.size() };
+    std::vector<AlertTransition> transitions;
+
+    for (int t = 0; t < ticks; ++t) {
+        for (std::size_t i = 0; i < pumps.size(); ++i) {
+            PumpSimulation& pump = *pumps[i];
+            bg[i] = pump.step();
+            if (t % mealEvery == mealEvery / 2) {
+                pump.getPumpEngine().requestBolus(s.mealBolus, "Meal bolus");
+            }
+            reservoir[i] = pump.getDevice().getReservoir();
+            battery[i] = pump.getDevice().getBatteryLevel();
+        }
+        transitions.clear();
+        alerts.evaluate(levels, pumps[0]->getSimClock().now(), transitions);
+        for (const AlertTransition& a : transitions) {
+            if (!a.raised || a.channel > AlertChannel::BgHigh) continue;
+            PumpSimulation& pump = *pumps[a.patient];
+            pump.getHistoryManager().addRecord({
+                pump.getSimClock().now(), RecordType::Warning, 0.0,
+                std::string(CohortAlerts::channelName(a.channel)) + " (" + formatFixed(a.value, 1) + ")!"
+            });
+        }
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    const double totalTicks = static_cast<double>(ticks) * s.pumps;
+
+    Measurement m;
+    m.ticksPerSecond = totalTicks / seconds;
+    m.allocsPerTick = static_cast<double>(BenchAlloc::count() - allocsBefore) / totalTicks;
+    m.peakRssKb = peakRssKb();
+    for (auto& pump : pumps) {
+        m.historyRecords += pump->getHistoryManager().getRecords().size();
+    }
+    return m;
+}
+
+/**
+ * @brief runIsolated runs a scenario in a forked child so its peak RSS
+ * is its own, and reads the measurement back over a pipe.
+ */
+bool runIsolated(const Workload& s, Measurement& out)
+{
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        Measurement m = runScenario(s);
+        ssize_t written = write(fds[1], &m, sizeof(m));
+        _exit(written == static_cast<ssize_t>(sizeof(m)) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ssize_t got = read(fds[0], &out, sizeof(out));
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return got == static_cast<ssize_t>(sizeof(out)) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+bool writeResults(const std::string& path, const std::vector<std::pair<const Workload*, Measurement>>& results,
+                  const Tolerances& tol, std::string& error)
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        error = "Cannot open " + path + " for writing.";
+        return false;
+    }
+    std::fprintf(f, "{\n  \"suite\": \"pumpcore-perf\",\n");
+    std::fprintf(f, "  \"tolerances\": {\"ticks_per_second\": %g, \"allocs_per_tick\": %g, \"peak_rss_kb\": %g},\n",
+                 tol.throughput, tol.allocs, tol.rss);
+    std::fprintf(f, "  \"scenarios\": [");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Measurement& m = results[i].second;
+        std::fprintf(f, "%s\n    {\"name\": \"%s\", \"ticks_per_second\": %.0f, \"allocs_per_tick\": %.4f, "
+                        "\"peak_rss_kb\": %ld, \"history_records\": %llu}",
+                     i ? "," : "", results[i].first->name, m.ticksPerSecond, m.allocsPerTick,
+                     m.peakRssKb, static_cast<unsigned long long>(m.historyRecords));
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+    bool ok = std::ferror(f) == 0;
+    if (std::fclose(f) != 0) ok = false;
+    if (!ok) error = "Failed writing " + path + ".";
+    return ok;
+}
+
+/**
+ * @brief check prints one comparison line and returns false on a regression.
+ * higherIsBetter flips the direction of the tolerance.
+ */
+bool check(const char* scenario, const char* metric, double base, double now,
+           double tolerance, bool higherIsBetter)
+{
+    double delta = base != 0.0 ? (now - base) / base : 0.0;
+    bool regressed = higherIsBetter ? now < base * (1.0 - tolerance)
+                                    : now > base * (1.0 + tolerance) + 0.01;
+    std::printf("  %-24s %-18s %14.2f %14.2f %+8.1f%%  %s\n", scenario, metric, base, now,
+                delta * 100.0, regressed ? "REGRESSED" : "ok");
+    return !regressed;
+}
+
+} // namespace
+
+/**
+ * @brief Performance regression gate.
+ *
+ * Usage: pumpcore-perf [--baseline FILE] [--json FILE] [--write-baseline FILE]
+ *                      [--filter SUBSTRING] [--repeats N]
+ *
+ * Runs each scenario --repeats times (default 3) in a child process and
+ * keeps the best throughput and lowest peak RSS. With --baseline, compares
+ * throughput, allocations per tick and peak RSS with the stored values
+ * and exits 1 if any regresses past the file's tolerances.
+ */
+int main(int argc, char *argv[])
+{
+    std::string baselinePath, jsonPath, writeBaselinePath, filter;
+    int repeats = 3;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc) {
+            writeBaselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--repeats") == 0 && i + 1 < argc) {
+            repeats = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "Usage: %s [--baseline FILE] [--json FILE] [--write-baseline FILE] "
+                                 "[--filter SUBSTRING] [--repeats N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::string error;
+    JsonValue baseline;
+    Tolerances tol;
+    if (!baselinePath.empty()) {
+        if (!readJsonFile(baselinePath, baseline, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+        if (const JsonValue* t = baseline.find("tolerances")) {
+            tol.throughput = t->numberOr("ticks_per_second", tol.throughput);
+            tol.allocs = t->numberOr("allocs_per_tick", tol.allocs);
+            tol.rss = t->numberOr("peak_rss_kb", tol.rss);
+        }
+    }
+
+    std::vector<std::pair<const Workload*, Measurement>> results;
+    for (const Workload& s : scenarios) {
+        if (!filter.empty() && std::strstr(s.name, filter.c_str()) == nullptr) continue;
+
+        Measurement best;
+        for (int r = 0; r < repeats; ++r) {
+            Measurement m;
+            if (!runIsolated(s, m)) {
+                std::fprintf(stderr, "%s: scenario run failed\n", s.name);
+                return 2;
+            }
+            if (r == 0 || m.ticksPerSecond > best.ticksPerSecond) best.ticksPerSecond = m.ticksPerSecond;
+            if (r == 0 || m.peakRssKb < best.peakRssKb) best.peakRssKb = m.peakRssKb;
+            best.allocsPerTick = m.allocsPerTick;
+            best.historyRecords = m.historyRecords;
+        }
+        std::printf("%-24s %12.0f ticks/s %8.2f allocs/tick %9ld KB peak RSS %9llu records\n",
+                    s.name, best.ticksPerSecond, best.allocsPerTick, best.peakRssKb,
+                    static_cast<unsigned long long>(best.historyRecords));
+        results.emplace_back(&s, best);
+    }
+
+    if (!jsonPath.empty() && !writeResults(jsonPath, results, tol, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 2;
+    }
+    if (!writeBaselinePath.empty() && !writeResults(writeBaselinePath, results, tol, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 2;
+    }
+    if (baselinePath.empty()) {
+        return 0;
+    }
+
+    std::printf("\nCompared with %s (tolerances: throughput -%.0f%%, allocs +%.0f%%, RSS +%.0f%%)\n",
+                baselinePath.c_str(), tol.throughput * 100, tol.allocs * 100, tol.rss * 100);
+    bool ok = true;
+    const JsonValue* stored = baseline.find("scenarios");
+    for (const auto& result : results) {
+        const JsonValue* base = nullptr;
+        if (stored) {
+            for (const JsonValue& entry : stored->array) {
+                const JsonValue* name = entry.find("name");
+                if (name && name->string == result.first->name) base = &entry;
+            }
+        }
+        if (!base) {
+            std::printf("  %-24s no baseline, skipped\n", result.first->name);
+            continue;
+        }
+        const Measurement& m = result.second;
+        ok &= check(result.first->name, "ticks_per_second", base->numberOr("ticks_per_second", 0),
+                    m.ticksPerSecond, tol.throughput, true);
+        ok &= check(result.first->name, "allocs_per_tick", base->numberOr("allocs_per_tick", 0),
+                    m.allocsPerTick, tol.allocs, false);
+        ok &= check(result.first->name, "peak_rss_kb", base->numberOr("peak_rss_kb", 0),
+                    static_cast<double>(m.peakRssKb), tol.rss, false);
+    }
+
+    std::printf("%s\n", ok ? "PASS" : "FAIL: performance regressed past tolerance");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+# Performance regression gate: runs fixed scenarios and compares them with
+# baseline.json. Uses fork() and getrusage(), so Unix only.
+TEMPLATE = app
+TARGET = pumpcore-perf
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../core/pumpcore.pri)
+
+INCLUDEPATH += ../bench
+
+SOURCES += \
+    ../bench/Bench.cpp \
+    Json.cpp \
+    main.cpp
+
+HEADERS += \
+    ../bench/Bench.h \
+    Json.h
@@ -0,0 +1,216 @@
+#include "Protocol.h"
+#include <cstring>
+
+namespace Protocol {
+
+std::size_t beginFrame(std::string& out, MessageType type)
+{
+    std::size_t start = out.size();
+    BinaryWriter w(out);
+    w.put<std::uint32_t>(0);
+    w.put(static_cast<std::uint8_t>(type));
+    return start;
+}
+
+void endFrame(std::string& out, std::size_t start)
+{
+    std::uint32_t length = static_cast<std::uint32_t>(out.size() - start - sizeof(std::uint32_t));
+    std::memcpy(&out[start], &length, sizeof(length));
+}
+
+bool nextFrame(const std::string& in, std::size_t& pos, MessageType& type,
+               BinaryReader& payload, bool& bad)
+{
+    bad = false;
+    std::uint32_t length = 0;
+    if (in.size() - pos < sizeof(length)) return false;
+    std::memcpy(&length, in.data() + pos, sizeof(length));
+    if (length == 0 || length > maxFrameBytes) {
+        bad = true;
+        return false;
+    }
+    if (in.size() - pos - sizeof(length) < length) return false;
+
+    const char* frame = in.data() + pos + sizeof(length);
+    type = static_cast<MessageType>(static_cast<std::uint8_t>(frame[0]));
+    payload = BinaryReader(frame + 1, length - 1);
+    pos += sizeof(length) + length;
+    return true;
+}
+
+void encode(std::string& out, const CreatePump& m)
+{
+    std::size_t f = beginFrame(out, MessageType::CreatePump);
+    BinaryWriter w(out);
+    w.put(m.request);
+    w.put(m.seed);
+    w.put(static_cast<std::uint8_t>(m.controller));
+    w.putString(m.scenario);
+    endFrame(out, f);
+}
+
+void encode(std::string& out, MessageType type, const PumpRequest& m)
+{
+    std::size_t f = beginFrame(out, type);
+    BinaryWriter w(out);
+    w.put(m.request);
+    w.put(m.pump);
+    endFrame(out, f);
+}
+
+void encode(std::string& out, const Subscribe& m)
+{
+    std::size_t f = beginFrame(out, MessageType::Subscribe);
+    BinaryWriter w(out);
+    w.put(m.request);
+    w.put(m.pump);
+    w.put(m.streams);
+    endFrame(out, f);
+}
+
+void encode(std::string& out, const RequestBolus& m)
+{
+    std::size_t f = beginFrame(out, MessageType::RequestBolus);
+    BinaryWriter w(out);
+    w.put(m.request);
+    w.put(m.pump);
+    w.put(m.units);
+    w.put(m.extendedFraction);
+    w.put(m.extendedHours);
+    endFrame(out, f);
+}
+
+void encode(std::string& out, const Advance& m)
+{
+    std::size_t f = beginFrame(out, MessageType::Advance);
+    BinaryWriter w(out);
+    w.put(m.request);
+    w.put(m.ticks);
+    endFrame(out, f);
+}
+
+void encodeOk(std::string& out, std::uint32_t request)
+{
+    std::size_t f = beginFrame(out, MessageType::Ok);
+    BinaryWriter(out).put(request);
+    endFrame(out, f);
+}
+
+void encodeError(std::string& out, std::uint32_t request, const std::string& message)
+{
+    std::size_t f = beginFrame(out, MessageType::Error);
+    BinaryWriter w(out);
+    w.put(request);
+    w.putString(message);
+    endFrame(out, f);
+}
+
+void encodePumpCreated(std::string& out, std::uint32_t request, std::uint32_t pump)
+{
+    std::size_t f = beginFrame(out, MessageType::PumpCreated);
+    BinaryWriter w(out);
+    w.put(request);
+    w.put(pump);
+    endFrame(out, f);
+}
+
+void encodeBolusResult(std::string& out, std::uint32_t request, bool delivered)
+{
+    std::size_t f = beginFrame(out, MessageType::BolusResult);
+    BinaryWriter w(out);
+    w.put(request);
+    w.put<std::uint8_t>(delivered ? 1 : 0);
+    endFrame(out, f);
+}
+
+void encode(std::string& out, const PumpStatus& m)
+{
+    std::size_t f = beginFrame(out, MessageType::Status);
+    BinaryWriter w(out);
+    w.put(m.request);
+    w.put(m.pump);
+    w.put(m.minute);
+    w.put(m.bg);
+    w.put(m.iob);
+    w.put(m.reservoir);
+    w.put(m.battery);
+    endFrame(out, f);
+}
+
+void encode(std::string& out, const CgmReading& m)
+{
+    std::size_t f = beginFrame(out, MessageType::CgmReading);
+    BinaryWriter w(out);
+    w.put(m.pump);
+    w.put(m.minute);
+    w.put(m.bg);
+    w.put(m.iob);
+    endFrame(out, f);
+}
+
+void encode(std::string& out, const HistoryEvent& m)
+{
+    std::size_t f = beginFrame(out, MessageType::HistoryEvent);
+    BinaryWriter w(out);
+    w.put(m.pump);
+    w.put(m.minute);
+    w.put(static_cast<std::uint8_t>(m.type));
+    w.put(m.amount);
+    w.putString(m.notes);
+    endFrame(out, f);
+}
+
+bool decode(BinaryReader& in, CreatePump& m)
+{
+    std::uint8_t controller = 0;
+    if (!in.get(m.request) || !in.get(m.seed) || !in.get(controller) || !in.getString(m.scenario)
+        || controller > static_cast<std::uint8_t>(ControllerKind::Mpc))
+        return false;
+    m.controller = static_cast<ControllerKind>(controller);
+    return true;
+}
+
+bool decode(BinaryReader& in, PumpRequest& m)
+{
+    return in.get(m.request) && in.get(m.pump);
+}
+
+bool decode(BinaryReader& in, Subscribe& m)
+{
+    return in.get(m.request) && in.get(m.pump) && in.get(m.streams);
+}
+
+bool decode(BinaryReader& in, RequestBolus& m)
+{
+    return in.get(m.request) && in.get(m.pump) && in.get(m.units)
+        && in.get(m.extendedFraction) && in.get(m.extendedHours);
+}
+
+bool decode(BinaryReader& in, Advance& m)
+{
+    return in.get(m.request) && in.get(m.ticks);
+}
+
+bool decode(BinaryReader& in, PumpStatus& m)
+{
+    return in.get(m.request) && in.get(m.pump) && in.get(m.minute) && in.get(m.bg)
+        && in.get(m.iob) && in.get(m.reservoir) && in.get(m.battery);
+}
+
+bool decode(BinaryReader& in, CgmReading& m)
+{
+    return in.get(m.pump) && in.get(m.minute) && in.get(m.bg) && in.get(m.iob);
+}
+
+bool decode(BinaryReader& in, HistoryEvent& m)
+{
+    std::uint8_t type = 0;
+    if (!in.get(m.pump) || !in.get(m.minute) || !in.get(type) || !in.get(m.amount)
+        || !in.getString(m.notes)
+        || type > static_cast<std::uint8_t>(RecordType::Other))
+        return false;
+    m.type = static_cast<RecordType>(type);
+    return true;
+}
+
+} // namespace Protocol
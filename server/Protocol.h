@@ -0,0 +1,147 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "BinaryIo.h"
+#include "ControlIQ.h"
+#include "HistoryRecord.h"
+
+/**
+ * @brief Wire protocol between pumpsim-server and its clients.
+ *
+ * Every message is a frame: u32 length of what follows, u8 MessageType,
+ * then the fields below in order (host byte order, strings as u32
+ * length + bytes, see BinaryIo.h). Requests carry a client-chosen
+ * request number that the reply echoes; stream messages (CgmReading,
+ * HistoryEvent) carry none and arrive after each simulated tick.
+ */
+namespace Protocol {
+
+constexpr std::uint32_t maxFrameBytes = 1u << 20;
+
+enum class MessageType : std::uint8_t {
+    // Client to server
+    CreatePump = 1,     // request, u32 seed, u8 ControllerKind, string scenario ("" = none)
+    DestroyPump = 2,    // request, u32 pump (its owner only)
+    Subscribe = 3,      // request, u32 pump, u8 streams (StreamCgm | StreamHistory, 0 = none)
+    RequestBolus = 4,   // request, u32 pump (its owner only), f64 units (> 0), f64 extended fraction (0..1),
+                        // u8 extended hours (<= 24)
+    Advance = 5,        // request, u32 ticks: steps every pump, replies once done (at once if none are due)
+    GetStatus = 6,      // request, u32 pump
+
+    // Server to client
+    Ok = 64,            // request
+    Error = 65,         // request, string message
+    PumpCreated = 66,   // request, u32 pump
+    BolusResult = 67,   // request, u8 delivered
+    Status = 68,        // request, PumpStatus fields
+    CgmReading = 80,    // pump, i64 sim minute, f64 BG, f64 IOB
+    HistoryEvent = 81   // pump, i64 sim minute, u8 RecordType, f64 amount, string notes
+};
+
+enum StreamMask : std::uint8_t {
+    StreamCgm = 1,
+    StreamHistory = 2   // every record except CGM readings
+};
+
+struct CreatePump {
+    std::uint32_t request = 0;
+    std::uint32_t seed = 0;
+    ControllerKind controller = ControllerKind::Threshold;
+    std::string scenario;
+};
+
+struct PumpRequest {   // DestroyPump, GetStatus
+    std::uint32_t request = 0;
+    std::uint32_t pump = 0;
+};
+
+struct Subscribe {
+    std::uint32_t request = 0;
+    std::uint32_t pump = 0;
+    std::uint8_t streams = 0;
+};
+
+struct RequestBolus {
+    std::uint32_t request = 0;
+    std::uint32_t pump = 0;
+    double units = 0.0;
+    double extendedFraction = 0.0;
+    std::uint8_t extendedHours = 0;
+};
+
+struct Advance {
+    std::uint32_t request = 0;
+    std::uint32_t ticks = 0;
+};
+
+struct PumpStatus {
+    std::uint32_t request = 0;
+    std::uint32_t pump = 0;
+    std::int64_t minute = 0;
+    double bg = 0.0;
+    double iob = 0.0;
+    double reservoir = 0.0;
+    std::int32_t battery = 0;
+};
+
+struct CgmReading {
+    std::uint32_t pump = 0;
+    std::int64_t minute = 0;
+    double bg = 0.0;
+    double iob = 0.0;
+};
+
+struct HistoryEvent {
+    std::uint32_t pump = 0;
+    std::int64_t minute = 0;
+    RecordType type = RecordType::Other;
+    double amount = 0.0;
+    std::string notes;
+};
+
+/**
+ * @brief beginFrame appends a frame header with a placeholder length;
+ * endFrame patches it once the fields are written.
+ * @return where the frame starts, for endFrame
+ */
+std::size_t beginFrame(std::string& out, MessageType type);
+void endFrame(std::string& out, std::size_t start);
+
+/**
+ * @brief nextFrame finds the frame starting at pos in a receive buffer.
+ * @return true with type/payload set and pos moved past it, or false if
+ * the frame is incomplete (or, with bad set, oversized or empty)
+ */
+bool nextFrame(const std::string& in, std::size_t& pos, MessageType& type,
+               BinaryReader& payload, bool& bad);
+
+// Each encode appends one complete frame
+void encode(std::string& out, const CreatePump& m);
+void encode(std::string& out, MessageType type, const PumpRequest& m);   // DestroyPump, GetStatus
+void encode(std::string& out, const Subscribe& m);
+void encode(std::string& out, const RequestBolus& m);
+void encode(std::string& out, const Advance& m);
+void encodeOk(std::string& out, std::uint32_t request);
+void encodeError(std::string& out, std::uint32_t request, const std::string& message);
+void encodePumpCreated(std::string& out, std::uint32_t request, std::uint32_t pump);
+void encodeBolusResult(std::string& out, std::uint32_t request, bool delivered);
+void encode(std::string& out, const PumpStatus& m);
+void encode(std::string& out, const CgmReading& m);
+void encode(std::string& out, const HistoryEvent& m);
+
+// Each decode reads one payload; false if it is short
+bool decode(BinaryReader& in, CreatePump& m);
+bool decode(BinaryReader& in, PumpRequest& m);
+bool decode(BinaryReader& in, Subscribe& m);
+bool decode(BinaryReader& in, RequestBolus& m);
+bool decode(BinaryReader& in, Advance& m);
+bool decode(BinaryReader& in, PumpStatus& m);
+bool decode(BinaryReader& in, CgmReading& m);
+bool decode(BinaryReader& in, HistoryEvent& m);
+
+} // namespace Protocol
+
+#endif // PROTOCOL_H
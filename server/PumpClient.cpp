@@ -0,0 +1,71 @@
+#include "PumpClient.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+PumpClient::~PumpClient()
+{
+    close();
+}
+
+bool PumpClient::connect(const std::string& socketPath, std::string& error)
+{
+    close();
+    sockaddr_un addr {};
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        error = "Socket path too long: " + socketPath;
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        error = "Cannot connect to " + socketPath + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void PumpClient::close()
+{
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    out.clear();
+    in.clear();
+    inPos = 0;
+}
+
+bool PumpClient::flush()
+{
+    std::size_t sent = 0;
+    while (sent < out.size()) {
+        ssize_t n = ::send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<std::size_t>(n);
+    }
+    out.clear();
+    return true;
+}
+
+bool PumpClient::receive(Protocol::MessageType& type, BinaryReader& payload)
+{
+    for (;;) {
+        bool bad = false;
+        if (Protocol::nextFrame(in, inPos, type, payload, bad)) return true;
+        if (bad || fd < 0) return false;
+
+        // Keep the unread tail only; the returned payload is no longer needed
+        in.erase(0, inPos);
+        inPos = 0;
+        char buf[65536];
+        ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        in.append(buf, static_cast<std::size_t>(n));
+    }
+}
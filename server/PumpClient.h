@@ -0,0 +1,50 @@
+#ifndef PUMPCLIENT_H
+#define PUMPCLIENT_H
+
+#include <cstdint>
+#include <string>
+#include "Protocol.h"
+
+/**
+ * @brief PumpClient is a blocking client for pumpsim-server, for tests
+ * and load generators. Requests are encoded into a send buffer (see the
+ * Protocol encode functions) and written with flush(), so many can be
+ * pipelined in one write; receive() returns frames one at a time, replies
+ * and stream messages interleaved as the server sent them.
+ */
+class PumpClient
+{
+public:
+    PumpClient() = default;
+    ~PumpClient();
+
+    PumpClient(const PumpClient&) = delete;
+    PumpClient& operator=(const PumpClient&) = delete;
+
+    bool connect(const std::string& socketPath, std::string& error);
+    void close();
+
+    std::uint32_t nextRequest() { return requestCounter++; }
+
+    /**
+     * @brief The buffer requests are encoded into until flush().
+     */
+    std::string& outbox() { return out; }
+    bool flush();
+
+    /**
+     * @brief receive blocks for the next frame. payload stays valid until
+     * the next call.
+     * @return false once the connection is closed or broken
+     */
+    bool receive(Protocol::MessageType& type, BinaryReader& payload);
+
+private:
+    int fd = -1;
+    std::uint32_t requestCounter = 1;
+    std::string out;
+    std::string in;
+    std::size_t inPos = 0;
+};
+
+#endif // PUMPCLIENT_H
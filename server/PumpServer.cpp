@@ -0,0 +1,567 @@
+#include "PumpServer.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::uint64_t nowNs()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+std::string errnoText(const std::string& what)
+{
+    return what + ": " + std::strerror(errno);
+}
+
+/**
+ * @brief checkBolus rejects a request the pump could not act on: a
+ * missing or negative amount, or an extended split outside 0..1 or
+ * 0..24 hours. Whether a valid dose is safe is the pump's decision.
+ */
+bool checkBolus(const Protocol::RequestBolus& m, std::string& error)
+{
+    if (!std::isfinite(m.units) || m.units <= 0.0) {
+        error = "Bolus units must be a number > 0";
+    } else if (!(m.extendedFraction >= 0.0 && m.extendedFraction <= 1.0)) {
+        error = "Extended fraction must be between 0 and 1";
+    } else if (m.extendedHours > PumpEngine::maxExtendedHours) {
+        error = "Extended hours must be at most " + std::to_string(PumpEngine::maxExtendedHours);
+    } else {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+PumpServer::PumpServer()
+    : connectionsAccepted(registry.counter("pump_server_connections_total", "Client connections accepted."))
+    , requests(registry.counter("pump_server_requests_total", "Requests handled."))
+    , badFrames(registry.counter("pump_server_bad_frames_total", "Connections closed for a malformed frame."))
+    , streamMessages(registry.counter("pump_server_stream_messages_total", "CGM and history messages queued to subscribers."))
+    , streamDropped(registry.counter("pump_server_stream_dropped_total", "Stream messages dropped for clients not reading."))
+    , ticks(registry.counter("pump_server_ticks_total", "Fleet ticks (every pump stepped once)."))
+    , pumpGauge(registry.gauge("pump_server_pumps", "Pumps in the fleet."))
+    , connectionGauge(registry.gauge("pump_server_connections", "Open client connections."))
+    , requestLatency(registry.histogram("pump_server_request_seconds", "Wall time to handle one request."))
+    , tickLatency(registry.histogram("pump_server_tick_seconds", "Wall time from start to end of a fleet tick, requests served in between included."))
+{
+}
+
+PumpServer::~PumpServer()
+{
+    for (auto& c : connections) {
+        if (c) ::close(c->fd);
+    }
+    for (int fd : { listenFd, epollFd, signalFd, timerFd }) {
+        if (fd >= 0) ::close(fd);
+    }
+    if (!socketPath.empty()) ::unlink(socketPath.c_str());
+}
+
+bool PumpServer::listen(const std::string& path, std::string& error)
+{
+    sockaddr_un addr {};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        error = "Socket path too long: " + path;
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        error = errnoText("socket");
+        return false;
+    }
+    ::unlink(path.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+        || ::listen(listenFd, SOMAXCONN) != 0) {
+        error = errnoText("Cannot listen on " + path);
+        return false;
+    }
+    socketPath = path;
+    return true;
+}
+
+bool PumpServer::run(std::string& error)
+{
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        error = errnoText("epoll_create1");
+        return false;
+    }
+
+    // SIGINT/SIGTERM arrive as a readable fd, so the loop stops cleanly
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+    signalFd = ::signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    if (tickPeriodMs > 0) {
+        timerFd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        itimerspec spec {};
+        spec.it_interval.tv_sec = tickPeriodMs / 1000;
+        spec.it_interval.tv_nsec = (tickPeriodMs % 1000) * 1000000L;
+        spec.it_value = spec.it_interval;
+        ::timerfd_settime(timerFd, 0, &spec, nullptr);
+    }
+
+    for (int fd : { listenFd, signalFd, timerFd }) {
+        if (fd < 0) continue;
+        epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.u64 = static_cast<std::uint64_t>(fd);
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            error = errnoText("epoll_ctl");
+            return false;
+        }
+    }
+
+    running = true;
+    epoll_event events[256];
+    while (running) {
+        // While a tick is under way, only poll the sockets between slices
+        const bool ticking = ticksDone < ticksTarget;
+        int n = ::epoll_wait(epollFd, events, 256, ticking ? 0 : -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            error = errnoText("epoll_wait");
+            return false;
+        }
+        for (int i = 0; i < n && running; ++i) {
+            // Connections are tagged with the fd and a generation, so an
+            // event for a connection closed earlier in this batch is not
+            // applied to a new one that reused its fd
+            const std::uint64_t tag = events[i].data.u64;
+            const int fd = static_cast<int>(tag & 0xffffffffu);
+            if (fd == listenFd) {
+                acceptAll();
+            } else if (fd == signalFd) {
+                signalfd_siginfo info;
+                while (::read(signalFd, &info, sizeof(info)) == sizeof(info)) {}
+                running = false;
+            } else if (fd == timerFd) {
+                std::uint64_t expirations = 0;
+                if (::read(timerFd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                    ticksTarget += expirations;
+                }
+            } else if (fd >= 0 && static_cast<std::size_t>(fd) < connections.size() && connections[fd]
+                       && connections[fd]->generation == (tag >> 32)) {
+                Connection& c = *connections[fd];
+                if (events[i].events & EPOLLOUT) flush(c);
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) readFrom(c);
+            }
+        }
+        if (ticksDone < ticksTarget) stepSlice();
+        flushDirty();
+    }
+    return true;
+}
+
+void PumpServer::acceptAll()
+{
+    for (;;) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;   // EAGAIN: no more pending, or a transient error
+
+        if (static_cast<std::size_t>(fd) >= connections.size()) {
+            connections.resize(static_cast<std::size_t>(fd) + 1);
+        }
+        std::unique_ptr<Connection> c(new Connection());
+        c->fd = fd;
+        c->generation = nextGeneration++;
+        epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.u64 = (static_cast<std::uint64_t>(c->generation) << 32) | static_cast<std::uint32_t>(fd);
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            ::close(fd);
+            continue;
+        }
+        connections[fd] = std::move(c);
+        connectionsAccepted.add();
+        connectionGauge.set(connectionGauge.get() + 1);
+    }
+}
+
+/**
+ * @brief readFrom drains the socket, then handles every complete frame.
+ * A partial frame stays buffered until the rest arrives.
+ */
+void PumpServer::readFrom(Connection& c)
+{
+    char buf[65536];
+    bool closed = false;
+    for (;;) {
+        ssize_t n = ::recv(c.fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            c.in.append(buf, static_cast<std::size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        closed = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+        break;
+    }
+
+    std::size_t pos = 0;
+    Protocol::MessageType type;
+    BinaryReader payload(nullptr, 0);
+    bool bad = false;
+    while (Protocol::nextFrame(c.in, pos, type, payload, bad)) {
+        handleFrame(c, type, payload);
+    }
+    if (bad) {
+        badFrames.add();
+        closed = true;
+    }
+    c.in.erase(0, pos);
+
+    if (closed) closeConnection(c);
+}
+
+void PumpServer::handleFrame(Connection& c, Protocol::MessageType type, BinaryReader& payload)
+{
+    PUMP_TRACE_SCOPE("server", "PumpServer::handleFrame");
+    using Protocol::MessageType;
+    const std::uint64_t started = nowNs();
+    requests.add();
+
+    bool ok = true;
+    switch (type) {
+    case MessageType::CreatePump: {
+        Protocol::CreatePump m;
+        if (!(ok = Protocol::decode(payload, m))) break;
+        std::shared_ptr<const Scenario> scenario;
+        if (!m.scenario.empty()) {
+            std::weak_ptr<const Scenario>& cached = scenarios[m.scenario];
+            scenario = cached.lock();
+            if (!scenario) {
+                auto parsed = std::make_shared<Scenario>();
+                std::string error;
+                if (!Scenario::parse(m.scenario, *parsed, error)) {
+                    scenarios.erase(m.scenario);
+                    Protocol::encodeError(c.out, m.request, "Scenario " + error);
+                    break;
+                }
+                scenario = parsed;
+                cached = scenario;
+            }
+        }
+        Pump pump;
+        pump.sim.reset(new PumpSimulation(m.seed));
+        pump.sim->getPumpEngine().setController(m.controller);
+        if (scenario) pump.sim->setScenario(scenario);
+        pump.owner = c.fd;
+        std::uint32_t id = nextPumpId++;
+        pump.sim->getPumpEngine().setTelemetry(telemetry, id);
+        pumps.emplace(id, std::move(pump));
+        c.owned.push_back(id);
+        pumpGauge.set(static_cast<double>(pumps.size()));
+        Protocol::encodePumpCreated(c.out, m.request, id);
+        break;
+    }
+    case MessageType::DestroyPump: {
+        Protocol::PumpRequest m;
+        if (!(ok = Protocol::decode(payload, m))) break;
+        if (!findOwnedPump(c, m.request, m.pump)) break;
+        destroyPump(m.pump);
+        Protocol::encodeOk(c.out, m.request);
+        break;
+    }
+    case MessageType::Subscribe: {
+        Protocol::Subscribe m;
+        if (!(ok = Protocol::decode(payload, m))) break;
+        Pump* pump = findPump(c, m.request, m.pump);
+        if (!pump) break;
+        unsubscribe(m.pump, c.fd);
+        if (m.streams != 0) {
+            pump->subscribers.push_back({ c.fd, m.streams, pump->sim->getHistoryManager().size() });
+            c.subscribed.push_back(m.pump);
+        }
+        Protocol::encodeOk(c.out, m.request);
+        break;
+    }
+    case MessageType::RequestBolus: {
+        Protocol::RequestBolus m;
+        if (!(ok = Protocol::decode(payload, m))) break;
+        Pump* pump = findOwnedPump(c, m.request, m.pump);
+        if (!pump) break;
+        std::string error;
+        if (!checkBolus(m, error)) {
+            Protocol::encodeError(c.out, m.request, error);
+            break;
+        }
+        bool delivered = pump->sim->getPumpEngine().requestBolus(m.units, "Remote bolus",
+                                                                 m.extendedFraction, m.extendedHours);
+        Protocol::encodeBolusResult(c.out, m.request, delivered);
+        publish(m.pump, *pump, false);
+        break;
+    }
+    case MessageType::Advance: {
+        Protocol::Advance m;
+        if (!(ok = Protocol::decode(payload, m))) break;
+        ticksTarget += m.ticks;
+        if (ticksTarget <= ticksDone) {
+            // Nothing to wait for (e.g. 0 ticks on an idle fleet)
+            Protocol::encodeOk(c.out, m.request);
+            break;
+        }
+        advanceWaiters.push_back({ c.fd, c.generation, m.request, ticksTarget });
+        break;
+    }
+    case MessageType::GetStatus: {
+        Protocol::PumpRequest m;
+        if (!(ok = Protocol::decode(payload, m))) break;
+        Pump* pump = findPump(c, m.request, m.pump);
+        if (!pump) break;
+        PumpSimulation& sim = *pump->sim;
+        Protocol::PumpStatus status;
+        status.request = m.request;
+        status.pump = m.pump;
+        status.minute = sim.getSimClock().now().minutes();
+        status.bg = sim.getCgmModel().getCurrentBg();
+        status.iob = sim.getPumpEngine().getInsulinOnBoard();
+        status.reservoir = sim.getDevice().getReservoir();
+        status.battery = sim.getDevice().getBatteryPercent();
+        Protocol::encode(c.out, status);
+        break;
+    }
+    default:
+        Protocol::encodeError(c.out, 0, "Unknown message type " + std::to_string(static_cast<int>(type)));
+        break;
+    }
+    if (!ok) {
+        Protocol::encodeError(c.out, 0, "Malformed message type " + std::to_string(static_cast<int>(type)));
+    }
+    queued(c);
+    requestLatency.record(nowNs() - started);
+}
+
+PumpServer::Pump* PumpServer::findPump(Connection& c, std::uint32_t request, std::uint32_t pumpId)
+{
+    auto it = pumps.find(pumpId);
+    if (it == pumps.end()) {
+        Protocol::encodeError(c.out, request, "No pump " + std::to_string(pumpId));
+        return nullptr;
+    }
+    return &it->second;
+}
+
+PumpServer::Pump* PumpServer::findOwnedPump(Connection& c, std::uint32_t request, std::uint32_t pumpId)
+{
+    Pump* pump = findPump(c, request, pumpId);
+    if (pump && pump->owner != c.fd) {
+        Protocol::encodeError(c.out, request, "Pump " + std::to_string(pumpId) + " belongs to another connection");
+        return nullptr;
+    }
+    return pump;
+}
+
+void PumpServer::closeConnection(Connection& c)
+{
+    const int fd = c.fd;
+    for (std::uint32_t id : c.subscribed) {
+        unsubscribe(id, fd);
+    }
+    // destroyPump edits c.owned, so walk a copy
+    const std::vector<std::uint32_t> owned = c.owned;
+    for (std::uint32_t id : owned) {
+        destroyPump(id);
+    }
+    dirty.erase(std::remove(dirty.begin(), dirty.end(), &c), dirty.end());
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections[fd].reset();
+    connectionGauge.set(connectionGauge.get() - 1);
+}
+
+void PumpServer::unsubscribe(std::uint32_t pumpId, int fd)
+{
+    auto it = pumps.find(pumpId);
+    if (it == pumps.end()) return;
+    std::vector<Subscriber>& subs = it->second.subscribers;
+    subs.erase(std::remove_if(subs.begin(), subs.end(), [fd](const Subscriber& s) { return s.fd == fd; }),
+               subs.end());
+}
+
+void PumpServer::destroyPump(std::uint32_t pumpId)
+{
+    auto it = pumps.find(pumpId);
+    if (it == pumps.end()) return;
+    Connection* owner = connections[it->second.owner].get();
+    if (owner) {
+        owner->owned.erase(std::remove(owner->owned.begin(), owner->owned.end(), pumpId), owner->owned.end());
+    }
+    // The last pump running a script takes its parsed copy out of the cache
+    auto cached = scenarios.end();
+    if (const Scenario* script = it->second.sim->getScenarioRunner().getScenario()) {
+        cached = scenarios.find(script->getSource());
+    }
+    pumps.erase(it);
+    if (cached != scenarios.end() && cached->second.expired()) scenarios.erase(cached);
+    pumpGauge.set(static_cast<double>(pumps.size()));
+}
+
+/**
+ * @brief stepSlice steps pumps of the current fleet tick for about
+ * sliceBudgetNs. When a tick completes, Advance requests waiting for it
+ * are answered. Pumps created mid-tick join at the next tick; pumps
+ * destroyed mid-tick are skipped.
+ */
+void PumpServer::stepSlice()
+{
+    PUMP_TRACE_SCOPE("server", "PumpServer::stepSlice");
+    const std::uint64_t started = nowNs();
+    if (tickCursor == 0) {
+        tickStartedNs = started;
+        tickOrder.clear();
+        tickOrder.reserve(pumps.size());
+        for (const auto& entry : pumps) {
+            tickOrder.push_back(entry.first);
+        }
+    }
+
+    const std::uint64_t deadline = started + sliceBudgetNs;
+    while (tickCursor < tickOrder.size()) {
+        const std::uint32_t id = tickOrder[tickCursor++];
+        auto it = pumps.find(id);
+        if (it == pumps.end()) continue;
+        it->second.sim->step();
+        if (!it->second.subscribers.empty()) publish(id, it->second, true);
+        if ((tickCursor & 31) == 0 && nowNs() > deadline) return;
+    }
+
+    tickCursor = 0;
+    ++ticksDone;
+    ticks.add();
+    tickLatency.record(nowNs() - tickStartedNs);
+
+    while (!advanceWaiters.empty() && advanceWaiters.front().tick <= ticksDone) {
+        const AdvanceWaiter& w = advanceWaiters.front();
+        Connection* c = connections[w.fd].get();
+        if (c && c->generation == w.generation) {
+            Protocol::encodeOk(c->out, w.request);
+            queued(*c);
+        }
+        advanceWaiters.pop_front();
+    }
+}
+
+/**
+ * @brief publish queues the pump's latest reading (withCgm) and any new
+ * history records to each subscriber.
+ */
+void PumpServer::publish(std::uint32_t pumpId, Pump& pump, bool withCgm)
+{
+    PumpSimulation& sim = *pump.sim;
+    const HistoryManager& history = sim.getHistoryManager();
+    for (Subscriber& s : pump.subscribers) {
+        Connection* c = connections[s.fd].get();
+        if (!c) continue;
+        const bool backlogged = c->out.size() - c->outSent > maxQueuedBytes;
+
+        if (withCgm && (s.streams & Protocol::StreamCgm)) {
+            if (backlogged) {
+                streamDropped.add();
+            } else {
+                Protocol::encode(c->out, Protocol::CgmReading { pumpId, sim.getSimClock().now().minutes(),
+                                                                sim.getCgmModel().getCurrentBg(),
+                                                                sim.getPumpEngine().getInsulinOnBoard() });
+                streamMessages.add();
+            }
+        }
+        if (s.streams & Protocol::StreamHistory) {
+            for (std::size_t i = s.historySent; i < history.size(); ++i) {
+                const HistoryRecord& r = history.at(i);
+                if (r.getRecordType() == RecordType::CgmReading) continue;
+                if (backlogged) {
+                    streamDropped.add();
+                    continue;
+                }
+                Protocol::encode(c->out, Protocol::HistoryEvent { pumpId, r.getTime().minutes(), r.getRecordType(),
+                                                                  r.getInsulinAmount(), r.getNotes() });
+                streamMessages.add();
+            }
+        }
+        s.historySent = history.size();
+        queued(*c);
+    }
+}
+
+void PumpServer::queued(Connection& c)
+{
+    if (c.outSent < c.out.size() && !c.listedDirty) {
+        c.listedDirty = true;
+        dirty.push_back(&c);
+    }
+}
+
+void PumpServer::flushDirty()
+{
+    // flush never closes a connection, so the list stays valid while we walk it
+    for (Connection* c : dirty) {
+        c->listedDirty = false;
+        flush(*c);
+    }
+    dirty.clear();
+}
+
+/**
+ * @brief flush writes as much queued output as the socket takes. If it
+ * fills up, EPOLLOUT brings us back; on a write error the socket is shut
+ * down and the read side closes the connection.
+ */
+void PumpServer::flush(Connection& c)
+{
+    while (c.outSent < c.out.size()) {
+        ssize_t n = ::send(c.fd, c.out.data() + c.outSent, c.out.size() - c.outSent, MSG_NOSIGNAL);
+        if (n > 0) {
+            c.outSent += static_cast<std::size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Drop what was sent so the buffer does not grow without bound
+            if (c.outSent > (1u << 20)) {
+                c.out.erase(0, c.outSent);
+                c.outSent = 0;
+            }
+            watch(c, true);
+            return;
+        }
+        c.out.clear();
+        c.outSent = 0;
+        ::shutdown(c.fd, SHUT_RDWR);
+        return;
+    }
+    c.out.clear();
+    c.outSent = 0;
+    watch(c, false);
+}
+
+void PumpServer::watch(Connection& c, bool writable)
+{
+    if (c.wantsWrite == writable) return;
+    c.wantsWrite = writable;
+    epoll_event ev {};
+    ev.events = EPOLLIN | (writable ? EPOLLOUT : 0u);
+    ev.data.u64 = (static_cast<std::uint64_t>(c.generation) << 32) | static_cast<std::uint32_t>(c.fd);
+    ::epoll_ctl(epollFd, EPOLL_CTL_MOD, c.fd, &ev);
+}
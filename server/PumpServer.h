@@ -0,0 +1,168 @@
+#ifndef PUMPSERVER_H
+#define PUMPSERVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Metrics.h"
+#include "Protocol.h"
+#include "PumpSimulation.h"
+#include "TelemetryFeed.h"
+
+/**
+ * @brief PumpServer runs a fleet of PumpSimulations in one process and
+ * serves them over a Unix-domain socket (see Protocol.h).
+ *
+ * One thread runs an epoll loop over the listening socket, every client
+ * connection, a signalfd (SIGINT/SIGTERM stop the loop) and, when a tick
+ * period is set, a timerfd. Sockets are non-blocking: requests are
+ * handled as soon as their frame is complete and replies are queued on
+ * the connection and written straight away, waiting for EPOLLOUT only
+ * when the socket is full. Time advances for the whole fleet, on the
+ * timer or by Advance requests (replied to once their ticks are done),
+ * and each pump's subscribers get its reading and new history records
+ * as soon as it has stepped. A fleet tick is stepped in slices of about
+ * sliceBudgetNs with the sockets polled in between, so a request never
+ * waits for a whole tick of thousands of pumps; a pump is stepped
+ * exactly once per tick, before or after a request that touches it.
+ * A client that stops reading has its stream
+ * messages dropped (and counted) once maxQueuedBytes are pending;
+ * replies are always queued.
+ *
+ * Pumps belong to the connection that created them and are destroyed
+ * when it closes; only that connection may destroy one or request a
+ * bolus on it. Subscribe and GetStatus are open to every connection, so
+ * a monitor can watch pumps it does not own. Pumps given the same
+ * scenario text share one parsed copy, kept only while a pump runs it.
+ */
+class PumpServer
+{
+public:
+    static constexpr std::size_t maxQueuedBytes = 16u << 20;
+    static constexpr std::uint64_t sliceBudgetNs = 200000;
+
+    PumpServer();
+    ~PumpServer();
+
+    PumpServer(const PumpServer&) = delete;
+    PumpServer& operator=(const PumpServer&) = delete;
+
+    /**
+     * @brief listen binds path, replacing a stale socket file.
+     */
+    bool listen(const std::string& path, std::string& error);
+
+    /**
+     * @brief setTickPeriod steps the fleet every periodMs of real time
+     * (0, the default: only Advance requests move time). Call before run().
+     */
+    void setTickPeriod(int periodMs) { tickPeriodMs = periodMs; }
+
+    /**
+     * @brief setTelemetry publishes every pump's readings, decisions and
+     * deliveries to feed, tagged with the pump id (null: none). The loop
+     * thread is the feed's only producer. Call before run().
+     */
+    void setTelemetry(TelemetryFeed* feed) { telemetry = feed; }
+
+    /**
+     * @brief run serves until SIGINT/SIGTERM or stop().
+     */
+    bool run(std::string& error);
+    void stop() { running = false; }
+
+    std::size_t pumpCount() const { return pumps.size(); }
+    MetricsRegistry& getMetrics() { return registry; }
+
+private:
+    struct Subscriber {
+        int fd;
+        std::uint8_t streams;
+        std::size_t historySent;   // records already streamed
+    };
+
+    struct Pump {
+        std::unique_ptr<PumpSimulation> sim;
+        int owner;
+        std::vector<Subscriber> subscribers;
+    };
+
+    struct AdvanceWaiter {
+        int fd;
+        std::uint32_t generation;
+        std::uint32_t request;
+        std::uint64_t tick;   // reply once the fleet has done this many ticks
+    };
+
+    struct Connection {
+        int fd;
+        std::uint32_t generation;
+        std::string in;
+        std::string out;
+        std::size_t outSent = 0;
+        bool wantsWrite = false;
+        bool listedDirty = false;
+        std::vector<std::uint32_t> owned;
+        std::vector<std::uint32_t> subscribed;
+    };
+
+    std::string socketPath;
+    int listenFd = -1;
+    int epollFd = -1;
+    int signalFd = -1;
+    int timerFd = -1;
+    int tickPeriodMs = 0;
+    bool running = false;
+    TelemetryFeed* telemetry = nullptr;
+
+    std::unordered_map<std::uint32_t, Pump> pumps;
+    std::uint32_t nextPumpId = 1;
+    std::uint32_t nextGeneration = 1;
+    std::unordered_map<std::string, std::weak_ptr<const Scenario>> scenarios;   // by source
+    std::vector<std::unique_ptr<Connection>> connections;   // indexed by fd
+    std::vector<Connection*> dirty;                          // output queued this round
+
+    // Fleet ticks: done, and requested so far; the tick in progress
+    // steps the pumps in tickOrder from tickCursor on
+    std::uint64_t ticksDone = 0;
+    std::uint64_t ticksTarget = 0;
+    std::vector<std::uint32_t> tickOrder;
+    std::size_t tickCursor = 0;
+    std::uint64_t tickStartedNs = 0;
+    std::deque<AdvanceWaiter> advanceWaiters;
+
+    MetricsRegistry registry;
+    Counter& connectionsAccepted;
+    Counter& requests;
+    Counter& badFrames;
+    Counter& streamMessages;
+    Counter& streamDropped;
+    Counter& ticks;
+    Gauge& pumpGauge;
+    Gauge& connectionGauge;
+    LatencyHistogram& requestLatency;
+    LatencyHistogram& tickLatency;
+
+    void acceptAll();
+    void readFrom(Connection& c);
+    void handleFrame(Connection& c, Protocol::MessageType type, BinaryReader& payload);
+    void closeConnection(Connection& c);
+    void unsubscribe(std::uint32_t pumpId, int fd);
+    void destroyPump(std::uint32_t pumpId);
+    Pump* findPump(Connection& c, std::uint32_t request, std::uint32_t pumpId);
+    Pump* findOwnedPump(Connection& c, std::uint32_t request, std::uint32_t pumpId);
+
+    void stepSlice();
+    void publish(std::uint32_t pumpId, Pump& pump, bool withCgm);
+
+    void queued(Connection& c);
+    void flush(Connection& c);
+    void flushDirty();
+    void watch(Connection& c, bool writable);
+};
+
+#endif // PUMPSERVER_H
@@ -0,0 +1,76 @@
+#include "PumpServer.h"
+#include "TelemetryFeed.h"
+#include "Trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @brief pumpsim-server: a fleet of simulated pumps behind a Unix-domain
+ * socket (see PumpServer and Protocol.h).
+ *
+ * Usage: pumpsim-server [--socket PATH] [--period-ms P] [--metrics FILE] [--trace FILE]
+ *                       [--telemetry NAME]
+ *
+ * Without --period-ms time only moves on Advance requests, which keeps
+ * test runs deterministic; with it the fleet steps every P ms.
+ * --metrics writes the server's metrics when it stops (SIGINT/SIGTERM).
+ * --telemetry publishes every pump's events to the shared-memory feed NAME.
+ */
+int main(int argc, char *argv[])
+{
+    std::string socketPath = "/tmp/pumpsim.sock";
+    int periodMs = 0;
+    const char* metricsPath = nullptr;
+    const char* tracePath = nullptr;
+    const char* telemetryName = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--period-ms") == 0 && i + 1 < argc) {
+            periodMs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            metricsPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetryName = argv[++i];
+        } else {
+            std::fprintf(stderr, "Usage: %s [--socket PATH] [--period-ms P] [--metrics FILE] [--trace FILE] [--telemetry NAME]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Trace::setEnabled(tracePath != nullptr);
+    PumpServer server;
+    server.setTickPeriod(periodMs);
+    std::string error;
+    TelemetryFeed telemetry;
+    if (telemetryName) {
+        if (!telemetry.create(telemetryName, TelemetryFeed::defaultCapacity, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        server.setTelemetry(&telemetry);
+    }
+    if (!server.listen(socketPath, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    std::fprintf(stderr, "pumpsim-server listening on %s\n", socketPath.c_str());
+    if (!server.run(error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    if (metricsPath && !server.getMetrics().writeText(metricsPath, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    if (tracePath && !Trace::writeChromeJson(tracePath, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    return 0;
+}
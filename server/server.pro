@@ -0,0 +1,18 @@
+# Multi-pump simulation server on a Unix-domain socket. Uses epoll,
+# signalfd and timerfd, so Linux only.
+TEMPLATE = app
+TARGET = pumpsim-server
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../core/pumpcore.pri)
+
+SOURCES += \
+    Protocol.cpp \
+    PumpServer.cpp \
+    main.cpp
+
+HEADERS += \
+    Protocol.h \
+    PumpServer.h
@@ -0,0 +1,168 @@
+#include "ControllerPolicy.h"
+#include "Metrics.h"
+#include "SafetyRules.h"
+#include "StringUtil.h"
+#include "TelemetryFeed.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void onSignal(int)
+{
+    stopRequested = 1;
+}
+
+std::uint64_t nowNs()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+const char* actionName(std::uint8_t action)
+{
+    switch (static_cast<ControlAction>(action)) {
+    case ControlAction::None:         return "scheduled";
+    case ControlAction::SuspendBasal: return "suspend";
+    case ControlAction::AdjustBasal:  return "adjust";
+    case ControlAction::AutoBolus:    return "auto-bolus";
+    }
+    return "?";
+}
+
+const char* deliveryName(std::uint8_t kind)
+{
+    switch (static_cast<DeliveryKind>(kind)) {
+    case DeliveryKind::ManualBolus:   return "manual bolus";
+    case DeliveryKind::AutoBolus:     return "auto bolus";
+    case DeliveryKind::ExtendedSlice: return "extended";
+    }
+    return "?";
+}
+
+const char* blockName(std::uint8_t reason)
+{
+    switch (static_cast<BolusBlockReason>(reason)) {
+    case BolusBlockReason::None:                  return "none";
+    case BolusBlockReason::NonPositive:           return "non-positive";
+    case BolusBlockReason::ExceedsMaxSingle:      return "max single";
+    case BolusBlockReason::ExceedsDailyLimit:     return "daily limit";
+    case BolusBlockReason::Cooldown:              return "cooldown";
+    case BolusBlockReason::ExceedsIobCap:         return "IOB cap";
+    case BolusBlockReason::BgLockout:             return "BG lockout";
+    case BolusBlockReason::InsufficientReservoir: return "reservoir";
+    }
+    return "?";
+}
+
+void print(const TelemetryEvent& e)
+{
+    std::printf("pump %u  %s  ", e.pump, formatSimTime(SimTime::fromMinutes(e.simMinute)).c_str());
+    switch (e.kind) {
+    case TelemetryKind::CgmReading:
+        std::printf("reading   BG %.1f  IOB %.2f\n", e.bg, e.insulinOnBoard);
+        break;
+    case TelemetryKind::Decision:
+        std::printf("decision  %s  predBG %.1f  basal %.2f U/h", actionName(e.detail), e.bg, e.rate);
+        if (e.units > 0.0) std::printf("  bolus %.2f U", e.units);
+        std::printf("\n");
+        break;
+    case TelemetryKind::Delivery:
+        std::printf("delivery  %s %.2f U  IOB %.2f\n", deliveryName(e.detail), e.units, e.insulinOnBoard);
+        break;
+    case TelemetryKind::BolusBlocked:
+        std::printf("blocked   %.2f U (%s)\n", e.units, blockName(e.detail));
+        break;
+    default:
+        std::printf("unknown event kind %u\n", static_cast<unsigned>(e.kind));
+        break;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief pumpsim-telemetry: follows a telemetry feed published by
+ * pumpsim-headless, pumpsim-server or the GUI (PUMPSIM_TELEMETRY).
+ *
+ * Usage: pumpsim-telemetry NAME [--from-start] [--count N] [--quiet]
+ *
+ * Events are read in place from the shared ring. --from-start replays
+ * what the ring still holds before following new events; --quiet only
+ * counts them. On exit (SIGINT, or after --count events) it reports how
+ * many were read, how many were overwritten before it got to them, and
+ * the delay from publish to read.
+ */
+int main(int argc, char *argv[])
+{
+    const char* name = nullptr;
+    bool fromStart = false;
+    bool quiet = false;
+    long long count = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--from-start") == 0) {
+            fromStart = true;
+        } else if (std::strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            count = std::atoll(argv[++i]);
+        } else if (!name && argv[i][0] != '-') {
+            name = argv[i];
+        } else {
+            name = nullptr;
+            break;
+        }
+    }
+    if (!name) {
+        std::fprintf(stderr, "Usage: %s NAME [--from-start] [--count N] [--quiet]\n", argv[0]);
+        return 2;
+    }
+
+    TelemetryReader reader;
+    std::string error;
+    if (!reader.open(name, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    if (fromStart) reader.seekToOldest();
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    LatencyHistogram delay;
+    long long read = 0;
+    int idle = 0;
+    while (!stopRequested && (count <= 0 || read < count)) {
+        const TelemetryEvent* event = reader.peek();
+        if (!event) {
+            // Spin briefly for bursts, then back off so an idle feed costs nothing
+            if (++idle > 1000) std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+        idle = 0;
+        std::uint64_t publishedNs = event->timeNs;
+        if (quiet) {
+            if (!reader.consume()) continue;
+        } else {
+            TelemetryEvent copy = *event;   // printing is slow: check before using it
+            if (!reader.consume()) continue;
+            print(copy);
+        }
+        std::uint64_t now = nowNs();
+        delay.record(now > publishedNs ? now - publishedNs : 0);
+        ++read;
+    }
+
+    std::fflush(stdout);
+    std::fprintf(stderr, "read %lld events, lost %llu, delay p50 %.1f us, p99 %.1f us, max %.1f us\n",
+                 read, static_cast<unsigned long long>(reader.lost()),
+                 delay.quantile(0.5) / 1e3, delay.quantile(0.99) / 1e3, delay.max() / 1e3);
+    return 0;
+}
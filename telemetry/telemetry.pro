@@ -0,0 +1,11 @@
+# Tails a pump telemetry feed in POSIX shared memory (see core/TelemetryFeed.h).
+TEMPLATE = app
+TARGET = pumpsim-telemetry
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../core/pumpcore.pri)
+
+SOURCES += \
+    main.cpp